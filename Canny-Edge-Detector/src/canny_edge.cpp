@@ -43,35 +43,19 @@ void computeGaussianDerivativeKernel(float kernel[], float sigma) {
 	}
 }
 
-/* Convolution using separables required for computing X and Y Gradients */
-void convolveSeparable(ImgGray img, int width, int halfwidth, float hKernel[], float vKernel[], ImgFloat& out) {
-	ImgFloat tmp;
-	tmp.Reset(img.Width(), img.Height());
-	Set(&tmp, 0);
-	//Convolve Horizontal
-	for (int i = 0; i < img.Height(); ++i) {
-		for (int j = halfwidth; j < img.Width() - halfwidth; ++j) {
-			float val = 0;
-			for (int k = 0; k < width; ++k) {
-				val += (hKernel[k] * img(j + halfwidth - k, i));
-			}
-			tmp(j, i) = val;
-		}
-	}
-	//Convolve Vertical
-	for (int i = halfwidth; i < img.Height() - halfwidth; ++i) {
-		for (int j = 0; j < img.Width(); ++j) {
-			float val = 0;
-			for (int k = 0; k < width; ++k) {
-				val += (vKernel[k] * tmp(j, i + halfwidth - k));
-			}
-			out(j, i) = val;
-		}
+/* Compute the X and Y Gradients with the Gaussian and Gaussian derivative kernels */
+void computeGradients(const ImgGray& img, int width, float gaussianKernel[], float gaussianDerivativeKernel[], ImgFloat& Gx, ImgFloat& Gy) {
+	ImgFloat gauss(width, 1), gaussDeriv(width, 1);
+	for (int i = 0; i < width; ++i) {
+		gauss(i, 0) = gaussianKernel[i];
+		gaussDeriv(i, 0) = gaussianDerivativeKernel[i];
 	}
+	ConvolveSeparable(img, gaussDeriv, gauss, &Gx);
+	ConvolveSeparable(img, gauss, gaussDeriv, &Gy);
 }
 
 /* Compute Non-Maximum Suppression */
-void computeNonMaximumSuppression(ImgFloat magImg, ImgFloat phaseImg, int halfwidth, ImgFloat& suppressedImg) {
+void computeNonMaximumSuppression(const ImgFloat& magImg, const ImgFloat& phaseImg, int halfwidth, ImgFloat& suppressedImg) {
 	for (int y = halfwidth; y < magImg.Height() - halfwidth; ++y) {
 		for (int x = halfwidth; x < magImg.Width() - halfwidth; ++x) {
 
@@ -104,7 +88,7 @@ void computeNonMaximumSuppression(ImgFloat magImg, ImgFloat phaseImg, int halfwi
 }
 
 /* Floodfill required for Edge Linking with Hysteresis (Double Thresholding) */
-void floodfill(ImgBinary& img, ImgFloat suppressedImg, int x, int y, float low_threshold) {
+void floodfill(ImgBinary& img, const ImgFloat& suppressedImg, int x, int y, float low_threshold) {
 	if (x <0 || x >= img.Width() || y <0 || y >= img.Height()) return;
 
 	stack<int> x_cor;
@@ -135,7 +119,7 @@ void floodfill(ImgBinary& img, ImgFloat suppressedImg, int x, int y, float low_t
 }
 
 /*Computing Chamfer Distance*/
-void computeChamferDistance(ImgBinary img, ImgInt& chamferImg) {
+void computeChamferDistance(const ImgBinary& img, ImgInt& chamferImg) {
 	int max = img.Width() * img.Height() + 1;
 	//  Set(chamfer_dist, bignum);
 	int x, y;
@@ -174,7 +158,7 @@ void computeChamferDistance(ImgBinary img, ImgInt& chamferImg) {
 }
 
 /*Compute Inverse Probability Map*/
-void computeInverseProbabilityMap(ImgInt chamferImg, ImgGray templateImg, ImgBinary hystImg, ImgInt& probabilityMapImg) {
+void computeInverseProbabilityMap(const ImgInt& chamferImg, const ImgGray& templateImg, const ImgBinary& hystImg, ImgInt& probabilityMapImg) {
 	for (int y = 0; y < chamferImg.Height() - templateImg.Height(); ++y) {
 		for (int x = 0; x < chamferImg.Width() - templateImg.Width(); ++x) {
 			float sum = 0;
@@ -259,8 +243,7 @@ int main(int argc, const char* argv[], const char* envp[])
 		Gy.Reset(img1.Width(), img1.Height());
 		Set(&Gy, 0);
 
-		convolveSeparable(img1, w, mu, gaussianDerivativeKernel, gaussianKernel, Gx);
-		convolveSeparable(img1, w, mu, gaussianKernel, gaussianDerivativeKernel, Gy);
+		computeGradients(img1, w, gaussianKernel, gaussianDerivativeKernel, Gx, Gy);
 
 		/* Compute the Gradient Magnitudes and Phase */
 		ImgFloat imgMag, imgPhase;
@@ -351,8 +334,7 @@ int main(int argc, const char* argv[], const char* envp[])
 			template_Gy.Reset(templateImg.Width(), templateImg.Height());
 			Set(&template_Gy, 0);
 
-			convolveSeparable(templateImg, w, mu, gaussianDerivativeKernel, gaussianKernel, template_Gx);
-			convolveSeparable(templateImg, w, mu, gaussianKernel, gaussianDerivativeKernel, template_Gy);
+			computeGradients(templateImg, w, gaussianKernel, gaussianDerivativeKernel, template_Gx, template_Gy);
 
 			/* Compute the Gradient Magnitudes and Phase */
 			ImgFloat template_imgMag, template_imgPhase;
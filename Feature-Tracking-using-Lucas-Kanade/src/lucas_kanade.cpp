@@ -46,46 +46,8 @@ void computeGaussianDerivativeKernel(float kernel[], float sigma) {
 	}
 }
 
-/* Convolution using separables required for computing X and Y Gradients */
-void convolveSeparable(ImgGray img, int width, int halfwidth, float hKernel[], float vKernel[], ImgFloat& out) {
-	ImgFloat tmp;
-	tmp.Reset(img.Width(), img.Height());
-	Set(&tmp, 0);
-	int d;
-	//Convolve Horizontal
-	for (int i = 0; i < img.Height(); ++i) {
-		for (int j = 0; j < img.Width(); ++j) {
-			float val = 0;
-			for (int k = 0; k < width; ++k) {
-				if (j + halfwidth - k < 0)
-					d = -j - halfwidth + k;
-				else if (j + halfwidth - k >= img.Width())
-					d = img.Width() - (j + halfwidth - k) - 1;
-				else d = 0;
-				val += (hKernel[k] * img(j + halfwidth - k + d, i));
-			}
-			tmp(j, i) = val;
-		}
-	}
-	//Convolve Vertical
-	for (int i = 0; i < img.Height(); ++i) {
-		for (int j = 0; j < img.Width(); ++j) {
-			float val = 0;
-			for (int k = 0; k < width; ++k) {
-				if (i + halfwidth - k < 0)
-					d = -i - halfwidth + k;
-				else if (i + halfwidth - k >= img.Height())
-					d = img.Height() - (i + halfwidth - k) - 1;
-				else d = 0;
-				val += (vKernel[k] * tmp(j, i + halfwidth - k + d));
-			}
-			out(j, i) = val;
-		}
-	}
-}
-
 
-double InterpolateBilinear(ImgGray& frame, double x, double y)
+double InterpolateBilinear(const ImgGray& frame, double x, double y)
 {
 	double x0, y0, ax, ay;
 	x0 = floor(x);
@@ -101,7 +63,7 @@ double InterpolateBilinear(ImgGray& frame, double x, double y)
 	return ((1 - ax)*(1 - ay)*frame(x0, y0) + ax*(1 - ay)*frame(x0 + 1, y0) + (1 - ax)*ay*frame(x0, y0 + 1) + ax*ay*frame(x0 + 1, y0 + 1));
 }
 
-double InterpolateBilinear(ImgFloat& frame, double x, double y)
+double InterpolateBilinear(const ImgFloat& frame, double x, double y)
 {
 	double x0, y0, ax, ay;
 	x0 = floor(x);
@@ -117,44 +79,144 @@ double InterpolateBilinear(ImgFloat& frame, double x, double y)
 	return ((1 - ax)*(1 - ay)*frame(x0, y0) + ax*(1 - ay)*frame(x0 + 1, y0) + (1 - ax)*ay*frame(x0, y0 + 1) + ax*ay*frame(x0 + 1, y0 + 1));
 }
 
-void Compute2x2GradMat(int x, int y, double z[], ImgFloat& grad_x, ImgFloat& grad_y, int size)
+/* Number of samples along each side of the window used for tracking, which covers
+   offsets -(size - 1) / 2 up to (size + 1) / 2 - 1 */
+int WindowSamples(int size)
+{
+	return (size + 1) / 2 + (size - 1) / 2;
+}
+
+/* Bilinear interpolation of the tracking window around (x, y), stored row by row in out.
+   Every sample of the window shares the fractional part of (x, y), so the weights are computed once
+   per window instead of once per sample; the border clamping is the same as in InterpolateBilinear */
+template <typename T>
+void InterpolateWindow(const Image<T>& frame, double x, double y, int size, double out[])
 {
-	for (int j = -(size - 1) / 2; j < (size + 1) / 2; j++)
+	const int n = WindowSamples(size);
+	const double x0 = floor(x);
+	const double y0 = floor(y);
+	const double ax = x - x0;
+	const double ay = y - y0;
+	const double w00 = (1 - ax)*(1 - ay), w10 = ax*(1 - ay), w01 = (1 - ax)*ay, w11 = ax*ay;
+	const int first = -(size - 1) / 2;
+
+	for (int j = 0; j < n; j++)
 	{
-		for (int i = -(size - 1) / 2; i < (size + 1) / 2; i++)
+		int yj = (int) y0 + first + j;
+		if (yj < 0) yj = 0;
+		if (yj >= frame.Height() - 1) yj = frame.Height() - 2;
+		typename Image<T>::ConstIterator row0 = frame.Begin(0, yj);
+		typename Image<T>::ConstIterator row1 = frame.Begin(0, yj + 1);
+		for (int i = 0; i < n; i++)
 		{
-			z[0] = z[0] + InterpolateBilinear(grad_x, x + i, y + j) * InterpolateBilinear(grad_x, x + i, y + j);	//gxx
-			z[1] = z[1] + InterpolateBilinear(grad_x, x + i, y + j) * InterpolateBilinear(grad_y, x + i, y + j);	//gxy
-			z[2] = z[2] + InterpolateBilinear(grad_y, x + i, y + j) * InterpolateBilinear(grad_y, x + i, y + j);	//gyy
+			int xi = (int) x0 + first + i;
+			if (xi < 0) xi = 0;
+			if (xi >= frame.Width() - 1) xi = frame.Width() - 2;
+			out[j * n + i] = w00*row0[xi] + w10*row0[xi + 1] + w01*row1[xi] + w11*row1[xi + 1];
 		}
 	}
 }
 
-void ComputeZGradMat(int x, int y, double z[], ImgFloat& grad_x, ImgFloat& grad_y)
+/* Gradient matrix of the window around the integer position (x, y), summed over the interpolated samples,
+   which are stored in window. window is owned by the caller, so that it is allocated once rather than for every feature */
+void Compute2x2GradMat(int x, int y, double z[], const ImgFloat& grad_x, const ImgFloat& grad_y, int size, std::vector<double>& window)
 {
-	for (int j = -1; j < 2; j++)
+	const int samples = WindowSamples(size);
+	const int n = samples * samples;
+	if ((int) window.size() < 2 * n) window.resize(2 * n);
+	double* gx = &window[0];
+	double* gy = gx + n;
+	InterpolateWindow(grad_x, x, y, size, gx);
+	InterpolateWindow(grad_y, x, y, size, gy);
+
+	for (int k = 0; k < n; k++)
 	{
-		for (int i = -1; i < 2; i++)
-		{
-			z[0] = z[0] + grad_x(x + i, y + j) * grad_x(x + i, y + j);	//gxx
-			z[1] = z[1] + grad_x(x + i, y + j) * grad_y(x + i, y + j);	//gxy
-			z[2] = z[2] + grad_y(x + i, y + j) * grad_y(x + i, y + j);	//gyy
-		}
+		z[0] = z[0] + gx[k] * gx[k];	//gxx
+		z[1] = z[1] + gx[k] * gy[k];	//gxy
+		z[2] = z[2] + gy[k] * gy[k];	//gyy
 	}
 }
 
-void Compute2x1ErrorVector(double x, double y, double e[], double u[], ImgFloat& grad_x, ImgFloat& grad_y, ImgGray& currentframe, ImgGray& nextframe, int size)
+/* Sums of gxx, gxy and gyy over the (2 * radius + 1) x (2 * radius + 1) window around every pixel whose
+   window fits inside the image, stored row-major in z[0], z[1] and z[2] (zero elsewhere). Column sums are
+   slid down the image and window sums along each row, so the cost per pixel does not depend on the window size */
+void ComputeZGradSums(const ImgFloat& grad_x, const ImgFloat& grad_y, int radius, std::vector<double> z[3])
 {
-	for (int j = -(size - 1) / 2; j < (size + 1) / 2; j++)
+	const int width = grad_x.Width();
+	const int height = grad_x.Height();
+	const int size = 2 * radius + 1;
+	std::vector<double> column[3];
+	for (int k = 0; k < 3; k++)
+	{
+		z[k].assign(width * height, 0);
+		column[k].assign(width, 0);
+	}
+
+	for (int y = 0; y < height; y++)
 	{
-		for (int i = -(size - 1) / 2; i < (size + 1) / 2; i++)
+		// Add the row entering the window and remove the row leaving it
+		ImgFloat::ConstIterator gx = grad_x.Begin(0, y);
+		ImgFloat::ConstIterator gy = grad_y.Begin(0, y);
+		for (int x = 0; x < width; x++)
+		{
+			column[0][x] += gx[x] * gx[x];
+			column[1][x] += gx[x] * gy[x];
+			column[2][x] += gy[x] * gy[x];
+		}
+		if (y >= size)
 		{
-			e[0] = e[0] + InterpolateBilinear(grad_x, x + i, y + j)*(InterpolateBilinear(currentframe, x + i, y + j) - InterpolateBilinear(nextframe, x + i + u[0], y + j + u[1]));
-			e[1] = e[1] + InterpolateBilinear(grad_y, x + i, y + j)*(InterpolateBilinear(currentframe, x + i, y + j) - InterpolateBilinear(nextframe, x + i + u[0], y + j + u[1]));
+			gx = grad_x.Begin(0, y - size);
+			gy = grad_y.Begin(0, y - size);
+			for (int x = 0; x < width; x++)
+			{
+				column[0][x] -= gx[x] * gx[x];
+				column[1][x] -= gx[x] * gy[x];
+				column[2][x] -= gy[x] * gy[x];
+			}
+		}
+		if (y < size - 1)
+			continue;
+
+		double* out[3];
+		for (int k = 0; k < 3; k++)
+		{
+			out[k] = &z[k][(y - radius) * width - radius];
+		}
+		double sum[3] = { 0, 0, 0 };
+		for (int x = 0; x < width; x++)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				sum[k] += column[k][x];
+				if (x >= size) sum[k] -= column[k][x - size];
+				if (x >= size - 1) out[k][x] = sum[k];
+			}
 		}
 	}
 }
 
+/* Error vector of the window around (x, y), displaced by u in the next frame. The interpolated windows are
+   stored in window, which is owned by the caller so that it is allocated once rather than for every iteration */
+void Compute2x1ErrorVector(double x, double y, double e[], double u[], const ImgFloat& grad_x, const ImgFloat& grad_y, const ImgGray& currentframe, const ImgGray& nextframe, int size, std::vector<double>& window)
+{
+	const int n = WindowSamples(size) * WindowSamples(size);
+	if ((int) window.size() < 4 * n) window.resize(4 * n);
+	double* gx = &window[0];
+	double* gy = gx + n;
+	double* current = gy + n;
+	double* next = current + n;
+	InterpolateWindow(grad_x, x, y, size, gx);
+	InterpolateWindow(grad_y, x, y, size, gy);
+	InterpolateWindow(currentframe, x, y, size, current);
+	InterpolateWindow(nextframe, x + u[0], y + u[1], size, next);
+
+	for (int k = 0; k < n; k++)
+	{
+		e[0] = e[0] + gx[k] * (current[k] - next[k]);
+		e[1] = e[1] + gy[k] * (current[k] - next[k]);
+	}
+}
+
 void DrawSquare(int x, int y, ImgBgr& input)
 {
 	if ((x >0) && (y>0) && (x < input.Width() - 1) && (y < input.Height() - 1))
@@ -246,15 +308,15 @@ int main(int argc, const char* argv[], const char* envp[])
 			std::cout << gaussianDerivativeKernel[i] << std::endl;
 		}*/
 
-		/* Compute the X and Y Gradients */
+		/* Compute the X and Y Gradients, replicating the border pixels */
+		ImgFloat gaussian(w, 1), gaussianDerivative(w, 1);
+		for (int i = 0; i < w; ++i) {
+			gaussian(i, 0) = gaussianKernel[i];
+			gaussianDerivative(i, 0) = gaussianDerivativeKernel[i];
+		}
 		ImgFloat Gx, Gy;
-		Gx.Reset(width, height);
-		Set(&Gx, 0);
-		Gy.Reset(width, height);
-		Set(&Gy, 0);
-
-		convolveSeparable(firstImg, w, mu, gaussianDerivativeKernel, gaussianKernel, Gx);
-		convolveSeparable(firstImg, w, mu, gaussianKernel, gaussianDerivativeKernel, Gy);
+		ConvolveSeparable(firstImg, gaussianDerivative, gaussian, &Gx, BPO_BORDER_EXTEND);
+		ConvolveSeparable(firstImg, gaussian, gaussianDerivative, &Gy, BPO_BORDER_EXTEND);
 
 		ImgFloat corner;
 		corner.Reset(width, height);
@@ -266,16 +328,17 @@ int main(int argc, const char* argv[], const char* envp[])
 		std::cout << "Threshold : " << threshold << std::endl;
 
 		//find cornerness
+		std::vector<double> zSums[3];
+		ComputeZGradSums(Gx, Gy, 1, zSums);
 		for (int y = 1; y < height - 1; y++)
 		{
 			for (int x = 1; x < width - 1; x++)
 			{
-				double z[3] = { 0, 0, 0 };
+				double z[3] = { zSums[0][y * width + x], zSums[1][y * width + x], zSums[2][y * width + x] };
 				double lambda1 = 0;
 				double lambda2 = 0;
 				double cornerness = 0;
 
-				ComputeZGradMat(x, y, z, Gx, Gy);
 				lambda1 = 0.5*((z[0] + z[2]) + sqrt(SQR(z[0] - z[2]) + 4 * z[1] * z[1]));
 				lambda2 = 0.5*((z[0] + z[2]) - sqrt(SQR(z[0] - z[2]) + 4 * z[1] * z[1]));
 				cornerness = min(lambda1, lambda2);
@@ -343,6 +406,11 @@ int main(int argc, const char* argv[], const char* envp[])
 		float gaussDerivativeKernel[100];
 		computeGaussianDerivativeKernel(gaussDerivativeKernel, sigma);
 		
+		ImgFloat gauss(w, 1), gaussDerivative(w, 1);
+		for (int i = 0; i < w; ++i) {
+			gauss(i, 0) = gaussKernel[i];
+			gaussDerivative(i, 0) = gaussDerivativeKernel[i];
+		}
 
 		/* Compute the X and Y Gradients */
 		ImgFloat Gradx, Grady;
@@ -351,11 +419,14 @@ int main(int argc, const char* argv[], const char* envp[])
 		Grady.Reset(width, height);
 		Set(&Grady, 0);
 
-		ImgGray currentImg, nextImg;
-		currentImg.Reset(width, height);
-		nextImg.Reset(width, height);
-		Set(&currentImg, 0);
-		Set(&nextImg, 0);
+		// Two frame buffers used in turn: the frame loaded as the next frame becomes the current frame
+		// of the following pair, so each frame is loaded only once and both buffers keep their storage
+		ImgGray frames[2];
+		frames[0] = firstImg;
+		frames[1].Reset(width, height);
+		Set(&frames[1], 0);
+		int current = 0;
+		std::vector<double> window;				// Interpolated tracking windows, shared by every feature
 
 		CString file;
 		ImgBgr imgFinalFeature;
@@ -366,10 +437,9 @@ int main(int argc, const char* argv[], const char* envp[])
 		//for each pair of image
 		for (int k = firstFrame; k < lastFrame; k++)
 		{
-			//Take first frame
-			file.Format((LPCWSTR) format, k);
-			file = parentPath + file;
-			Load(file, &currentImg);
+			//First frame was loaded as the second frame of the previous pair
+			ImgGray& currentImg = frames[current];
+			ImgGray& nextImg = frames[1 - current];
 
 			//Take second frame
 			file.Format((LPCWSTR) format, k + 1);
@@ -377,8 +447,8 @@ int main(int argc, const char* argv[], const char* envp[])
 			Load(file, &nextImg);
 
 			//Compute gradient of first frame
-			convolveSeparable(currentImg, w, mu, gaussDerivativeKernel, gaussKernel, Gradx);
-			convolveSeparable(currentImg, w, mu, gaussKernel, gaussDerivativeKernel, Grady);
+			ConvolveSeparable(currentImg, gaussDerivative, gauss, &Gradx, BPO_BORDER_EXTEND);
+			ConvolveSeparable(currentImg, gauss, gaussDerivative, &Grady, BPO_BORDER_EXTEND);
 
 			for (int i = 0; i < featurecount; i++)
 			{
@@ -393,7 +463,7 @@ int main(int argc, const char* argv[], const char* envp[])
 					continue;
 				else
 				{
-					Compute2x2GradMat(feature_x[i], feature_y[i], zmat, Gradx, Grady, winSize);
+					Compute2x2GradMat(feature_x[i], feature_y[i], zmat, Gradx, Grady, winSize, window);
 				}
 
 				while (iteration < 1)
@@ -402,7 +472,7 @@ int main(int argc, const char* argv[], const char* envp[])
 					double u_delta = 0;
 					double v_delta = 0;
 
-					Compute2x1ErrorVector(feature_x[i], feature_y[i], emat, umat, Gradx, Grady, currentImg, nextImg, winSize);
+					Compute2x1ErrorVector(feature_x[i], feature_y[i], emat, umat, Gradx, Grady, currentImg, nextImg, winSize, window);
 
 					det = zmat[0] * zmat[2] - SQR(zmat[1]);
 					if (det == 0) det = 1;
@@ -426,6 +496,7 @@ int main(int argc, const char* argv[], const char* envp[])
 			}
 			figFinalFeatureTracking.Draw(imgFinalFeature);
 
+			current = 1 - current;
 		}
 
 	}
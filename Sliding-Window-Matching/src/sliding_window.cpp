@@ -7,6 +7,8 @@
 #include "../../src/blepo.h"
 #include <stack>
 #include <queue>
+#include "../../src/Quick/Quick.h"  // CanDoSse2
+#include <emmintrin.h>
 #ifdef _DEBUG
 #define new DEBUG_NEW
 #endif
@@ -15,72 +17,6 @@
 
 using namespace blepo;
 
-/* Compute the Gaussian Convolution Kernel */
-void computeGaussianKernel(float kernel[], float sigma) {
-	int mu = round(2.5 * sigma - 0.5);
-	int w = 2 * mu + 1;
-	float sum = 0;
-	for (int i = 0; i < w; ++i) {
-		kernel[i] = exp(-(i - mu)*(i - mu) / (2 * sigma*sigma));
-		sum += kernel[i];
-	}
-	for (int i = 0; i < w; ++i) {
-		kernel[i] /= sum;
-	}
-}
-
-/* Compute Gaussian Derivative Kernel */
-void computeGaussianDerivativeKernel(float kernel[], float sigma) {
-	int mu = round(2.5*sigma - 0.5);
-	int w = 2 * mu + 1;
-	float sum = 0;
-	for (int i = 0; i < w; ++i) {
-		kernel[i] = (i - mu) * exp(-(i - mu)*(i - mu) / (2 * sigma*sigma));
-		sum += kernel[i] * i;
-	}
-	for (int i = 0; i < w; ++i) {
-		kernel[i] /= sum;
-	}
-}
-
-/* Convolution using separables required for computing X and Y Gradients */
-void convolveSeparable(ImgGray img, int width, int halfwidth, float hKernel[], float vKernel[], ImgFloat& out) {
-	ImgFloat tmp;
-	tmp.Reset(img.Width(), img.Height());
-	Set(&tmp, 0);
-	int d;
-	//Convolve Horizontal
-	for (int i = 0; i < img.Height(); ++i) {
-		for (int j = 0; j < img.Width(); ++j) {
-			float val = 0;
-			for (int k = 0; k < width; ++k) {
-				if (j + halfwidth - k < 0)
-					d = -j - halfwidth + k;
-				else if (j + halfwidth - k >= img.Width())
-					d = img.Width() - (j + halfwidth - k) - 1;
-				else d = 0;
-				val += (hKernel[k] * img(j + halfwidth - k + d, i));
-			}
-			tmp(j, i) = val;
-		}
-	}
-	//Convolve Vertical
-	for (int i = 0; i < img.Height(); ++i) {
-		for (int j = 0; j < img.Width(); ++j) {
-			float val = 0;
-			for (int k = 0; k < width; ++k) {
-				if (i + halfwidth - k < 0)
-					d = -i - halfwidth + k;
-				else if (i + halfwidth - k >= img.Height())
-					d = img.Height() - (i + halfwidth - k) - 1;
-				else d = 0;
-				val += (vKernel[k] * tmp(j, i + halfwidth - k + d));
-			}
-			out(j, i) = val;
-		}
-	}
-}
-
 /* Floodfill required for Edge Linking with Hysteresis (Double Thresholding) */
 void floodfill(const ImgInt& img, ImgInt& outputImg, int x, int y, int new_label) {
 	if (x <0 || x >= img.Width() || y <0 || y >= img.Height()) return;
@@ -149,7 +85,7 @@ void floodfillMarker(const ImgBinary& img, ImgInt& outputImg, int x, int y, int
 }
 
 /*Computing Chamfer Distance*/
-void computeChamferDistance(ImgBinary img, ImgInt& chamferImg) {
+void computeChamferDistance(const ImgBinary& img, ImgInt& chamferImg) {
 	int max = img.Width() * img.Height() + 1;
 	//  Set(chamfer_dist, bignum);
 	int x, y;
@@ -350,27 +286,33 @@ void edgeDetection(const ImgInt& imgLabel, ImgBinary& imgEdge) {
 	}
 }
 
-/* Logical OR operation on two input images*/
-void logicalOr(const ImgBinary& input1, const ImgBinary& input2, ImgBinary& out) {
-	for (int y = 0; y < input1.Height() ; ++y) {
-		for (int x = 0; x < input1.Width() ; ++x) {
-			if (input1(x, y) == 1 || input2(x, y) == 1) {
-				out(x, y) = 1;
-			}
-		}
+/* SSE2 absolute differences of 16 pixels at a time between left[x] and right[x - d], widened to 16 bits.
+   Starts at x, which must be at least d, and returns the first pixel left for the scalar loop */
+int computeRowDissimilaritySse2(ImgGray::ConstIterator left, ImgGray::ConstIterator right, int x, int width, int d, ImgUShort::Iterator out) {
+	const __m128i zero = _mm_setzero_si128();
+	for (; x + 16 <= width; x += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i*) (left + x));
+		__m128i b = _mm_loadu_si128((const __m128i*) (right + x - d));
+		// |a - b| for unsigned bytes: one of the two saturating differences is always zero
+		__m128i diff = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+		_mm_storeu_si128((__m128i*) (out + x), _mm_unpacklo_epi8(diff, zero));
+		_mm_storeu_si128((__m128i*) (out + x + 8), _mm_unpackhi_epi8(diff, zero));
 	}
+	return x;
 }
 
-void quantizeImage(ImgGray& out, const ImgFloat& imgMag) {
-	float fmax = Max(imgMag);
-	float fmin = Min(imgMag);
-
-	int gmax = 255;
-	int gmin = 0;
-	for (int y = 0; y < imgMag.Height(); ++y) {
-		for (int x = 0; x < imgMag.Width(); ++x) {
-			out(x, y) = ((imgMag(x, y) - fmin) / (fmax - fmin)*(gmax - gmin)) + gmin;
-		}
+/* SAD dissimilarity of one row for disparity d, walking the rows through their start pointers.
+   Pixels left of d are matched against the first pixel of the right row, so the inner loop needs no clamping */
+void computeRowDissimilarity(ImgGray::ConstIterator left, ImgGray::ConstIterator right, int width, int d, ImgUShort::Iterator out) {
+	int x = 0;
+	for (; x < d && x < width; ++x) {
+		out[x] = blepo_ex::Abs <int> ((int)left[x] - (int)right[0]);
+	}
+	if (CanDoSse2()) {
+		x = computeRowDissimilaritySse2(left, right, x, width, d, out);
+	}
+	for (; x < width; ++x) {
+		out[x] = blepo_ex::Abs <int> ((int)left[x] - (int)right[x - d]);
 	}
 }
 
@@ -433,24 +375,14 @@ int main(int argc, const char* argv[], const char* envp[])
 		int width = imgLeft.Width();
 		int height = imgLeft.Height();
 		//Compute Dbar
-		ImgInt kernel = ImgInt(5, 1);
-		Set(&kernel, 1);
-		ImgInt kernelTranspose = ImgInt(1, 5);
-		Set(&kernelTranspose, 1);
-		std::vector<ImgInt> dBar(dmax);
+		const int windowRadius = 2;		// 5x5 matching window
+		std::vector<ImgUShort> dBar(dmax);
 		for (int d = 0; d < dmax; ++d) {
 			dBar[d].Reset(width, height);
 			for (int y = 0; y < height; ++y) {
-				for (int x = 0; x < width; ++x) {
-					
-					int tmp = (x - d) < 0 ? 0 : x - d;
-					
-					dBar[d](x, y) = blepo_ex::Abs <int> ( (int) imgLeftGray(x, y) - (int)imgRightGray( tmp, y) ); 
-				}
+				computeRowDissimilarity(imgLeftGray.Begin(0, y), imgRightGray.Begin(0, y), width, d, dBar[d].Begin(0, y));
 			}
-			ImgInt tmp;
-			Convolve(dBar[d], kernel, &tmp);
-			Convolve(tmp, kernelTranspose, &dBar[d]);
+			SumBox(dBar[d], windowRadius, windowRadius, &dBar[d], BPO_BORDER_ZERO);
 		}
 
 		//Compute Disparity Map with left-right consistency check
@@ -501,6 +433,9 @@ int main(int argc, const char* argv[], const char* envp[])
 		// Output to ply file
 		FILE * fptr;
 		fptr = fopen("../../images/output.ply", "wt");
+		if (fptr == NULL) {
+			BLEPO_ERROR("Unable to open output.ply for writing\n");
+		}
 		fprintf(fptr, "ply\nformat ascii 0.1\nelement vertex %d\nproperty float x\nproperty float y\nproperty float z\nproperty uchar diffuse_red\nproperty uchar diffuse_green\nproperty uchar diffuse_blue\nend_header\n", depth_count);
 		for (int y = 0; y < height; ++y) {
 			for (int x = 0; x < width; ++x) {
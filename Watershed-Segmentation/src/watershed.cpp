@@ -43,44 +43,6 @@ void computeGaussianDerivativeKernel(float kernel[], float sigma) {
 	}
 }
 
-/* Convolution using separables required for computing X and Y Gradients */
-void convolveSeparable(ImgGray img, int width, int halfwidth, float hKernel[], float vKernel[], ImgFloat& out) {
-	ImgFloat tmp;
-	tmp.Reset(img.Width(), img.Height());
-	Set(&tmp, 0);
-	int d;
-	//Convolve Horizontal
-	for (int i = 0; i < img.Height(); ++i) {
-		for (int j = 0; j < img.Width(); ++j) {
-			float val = 0;
-			for (int k = 0; k < width; ++k) {
-				if (j + halfwidth - k < 0)
-					d = -j - halfwidth + k;
-				else if (j + halfwidth - k >= img.Width())
-					d = img.Width() - (j + halfwidth - k) - 1;
-				else d = 0;
-				val += (hKernel[k] * img(j + halfwidth - k + d, i));
-			}
-			tmp(j, i) = val;
-		}
-	}
-	//Convolve Vertical
-	for (int i = 0; i < img.Height(); ++i) {
-		for (int j = 0; j < img.Width(); ++j) {
-			float val = 0;
-			for (int k = 0; k < width; ++k) {
-				if (i + halfwidth - k < 0)
-					d = -i - halfwidth + k;
-				else if (i + halfwidth - k >= img.Height())
-					d = img.Height() - (i + halfwidth - k) - 1;
-				else d = 0;
-				val += (vKernel[k] * tmp(j, i + halfwidth - k + d));
-			}
-			out(j, i) = val;
-		}
-	}
-}
-
 /* Floodfill required for Edge Linking with Hysteresis (Double Thresholding) */
 void floodfill(const ImgInt& img, ImgInt& outputImg, int x, int y, int new_label) {
 	if (x <0 || x >= img.Width() || y <0 || y >= img.Height()) return;
@@ -149,7 +111,7 @@ void floodfillMarker(const ImgBinary& img, ImgInt& outputImg, int x, int y, int
 }
 
 /*Computing Chamfer Distance*/
-void computeChamferDistance(ImgBinary img, ImgInt& chamferImg) {
+void computeChamferDistance(const ImgBinary& img, ImgInt& chamferImg) {
 	int max = img.Width() * img.Height() + 1;
 	//  Set(chamfer_dist, bignum);
 	int x, y;
@@ -350,26 +312,24 @@ void edgeDetection(const ImgInt& imgLabel, ImgBinary& imgEdge) {
 	}
 }
 
-/* Logical OR operation on two input images*/
-void logicalOr(const ImgBinary& input1, const ImgBinary& input2, ImgBinary& out) {
-	for (int y = 0; y < input1.Height() ; ++y) {
-		for (int x = 0; x < input1.Width() ; ++x) {
-			if (input1(x, y) == 1 || input2(x, y) == 1) {
-				out(x, y) = 1;
-			}
-		}
-	}
-}
-
 void quantizeImage(ImgGray& out, const ImgFloat& imgMag) {
-	float fmax = Max(imgMag);
-	float fmin = Min(imgMag);
+	// Minimum and maximum in one pass over the image
+	ImgFloat::ConstIterator p = imgMag.Begin();
+	float fmin = *p, fmax = *p;
+	for (; p != imgMag.End(); ++p) {
+		if (*p < fmin) fmin = *p;
+		else if (*p > fmax) fmax = *p;
+	}
 
 	int gmax = 255;
 	int gmin = 0;
+	// A flat image maps to gmin rather than dividing by a zero range
+	const float range = (fmax > fmin) ? fmax - fmin : 1;
 	for (int y = 0; y < imgMag.Height(); ++y) {
+		ImgFloat::ConstIterator in = imgMag.Begin(0, y);
+		ImgGray::Iterator row = out.Begin(0, y);
 		for (int x = 0; x < imgMag.Width(); ++x) {
-			out(x, y) = ((imgMag(x, y) - fmin) / (fmax - fmin)*(gmax - gmin)) + gmin;
+			row[x] = ((in[x] - fmin) / range * (gmax - gmin)) + gmin;
 		}
 	}
 }
@@ -433,15 +393,15 @@ int main(int argc, const char* argv[], const char* envp[])
 		float gaussianDerivativeKernel[100];
 		computeGaussianDerivativeKernel(gaussianDerivativeKernel, sigma);
 
-		/* Compute the X and Y Gradients */
+		/* Compute the X and Y Gradients, replicating the border pixels */
+		ImgFloat gaussian(w, 1), gaussianDerivative(w, 1);
+		for (int i = 0; i < w; ++i) {
+			gaussian(i, 0) = gaussianKernel[i];
+			gaussianDerivative(i, 0) = gaussianDerivativeKernel[i];
+		}
 		ImgFloat Gx, Gy;
-		Gx.Reset(img1.Width(), img1.Height());
-		Set(&Gx, 0);
-		Gy.Reset(img1.Width(), img1.Height());
-		Set(&Gy, 0);
-
-		convolveSeparable(img1, w, mu, gaussianDerivativeKernel, gaussianKernel, Gx);
-		convolveSeparable(img1, w, mu, gaussianKernel, gaussianDerivativeKernel, Gy);
+		ConvolveSeparable(img1, gaussianDerivative, gaussian, &Gx, BPO_BORDER_EXTEND);
+		ConvolveSeparable(img1, gaussian, gaussianDerivative, &Gy, BPO_BORDER_EXTEND);
 
 		/* Compute the Gradient Magnitudes */
 		ImgFloat imgMag;
@@ -506,12 +466,9 @@ int main(int argc, const char* argv[], const char* envp[])
 		Figure figEdge(L"Edge Image");
 		figEdge.Draw(imgEdge);
 
-		//Logical OR
+		//Logical OR, done by Blepo on the packed binary images rather than pixel by pixel
 		ImgBinary imgOr;
-		imgOr.Reset(width, height);
-		Set(&imgOr, 0);
-
-		logicalOr(imgThreshold, imgEdge, imgOr);
+		Or(imgThreshold, imgEdge, &imgOr);
 		
 		
 		Figure figOr(L"Marker Image");
@@ -563,25 +520,13 @@ int main(int argc, const char* argv[], const char* envp[])
 
 		// Copy the input image onto the final image
 		ImgBgr imgFinal;
-		imgFinal.Reset(width, height);
-		Set(&imgFinal, Bgr(0, 0, 0));
-		ImgGray::ConstIterator ptr = img1.Begin();
-		ImgBgr::Iterator ptr2 = imgFinal.Begin();
-		while (ptr != img1.End() || ptr2  != imgFinal.End() ) {
-			ptr2->b = *ptr;
-			ptr2->g = *ptr;
-			ptr2->r = *ptr;
-			++ptr;
-			++ptr2;
-		}
+		Convert(img1, &imgFinal);
 
 		// Color the edges green
 		for (int y = 0; y < height; ++y) {
 			for (int x = 0; x < width; ++x) {
 				if (imgMarkedEdge(x, y) == 1) {
-					imgFinal(x, y).b = 0;
-					imgFinal(x, y).g = 255;
-					imgFinal(x, y).r = 0;
+					imgFinal(x, y) = Bgr(0, 255, 0);
 				}
 			}
 		}
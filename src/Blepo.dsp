@@ -767,10 +767,26 @@ SOURCE=.\Image\PnmFile.h
 # End Group
 # Begin Source File
 
+SOURCE=.\Image\FrameArena.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\Image\Image.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\Image\FrameArena.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\Image\TiledImage.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\Image\SlidingHistogram.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\Image\Image.h
 # End Source File
 # Begin Source File
@@ -835,1096 +851,11 @@ SOURCE=.\Matrix\MatrixOperations.h
 # PROP Default_Filter ""
 # Begin Source File
 
-SOURCE=.\Quick\mmx_absdiff.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_absdiff.asm
-InputName=mmx_absdiff
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_absdiff.asm
-InputName=mmx_absdiff
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_and.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_and.asm
-InputName=mmx_and
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_and.asm
-InputName=mmx_and
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_const_and.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_const_and.asm
-InputName=mmx_const_and
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_const_and.asm
-InputName=mmx_const_and
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_const_diff.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_const_diff.asm
-InputName=mmx_const_diff
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_const_diff.asm
-InputName=mmx_const_diff
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_const_or.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_const_or.asm
-InputName=mmx_const_or
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_const_or.asm
-InputName=mmx_const_or
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_const_sum.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_const_sum.asm
-InputName=mmx_const_sum
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_const_sum.asm
-InputName=mmx_const_sum
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_const_xor.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_const_xor.asm
-InputName=mmx_const_xor
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_const_xor.asm
-InputName=mmx_const_xor
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_convolve_prewitt_horiz_abs.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_convolve_prewitt_horiz_abs.asm
-InputName=mmx_convolve_prewitt_horiz_abs
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_convolve_prewitt_horiz_abs.asm
-InputName=mmx_convolve_prewitt_horiz_abs
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_convolve_prewitt_vert_abs.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_convolve_prewitt_vert_abs.asm
-InputName=mmx_convolve_prewitt_vert_abs
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_convolve_prewitt_vert_abs.asm
-InputName=mmx_convolve_prewitt_vert_abs
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_dilate.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_dilate.asm
-InputName=mmx_dilate
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_dilate.asm
-InputName=mmx_dilate
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_erode.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_erode.asm
-InputName=mmx_erode
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_erode.asm
-InputName=mmx_erode
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_gauss_1x3.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_gauss_1x3.asm
-InputName=mmx_gauss_1x3
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_gauss_1x3.asm
-InputName=mmx_gauss_1x3
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_gauss_3x1.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_gauss_3x1.asm
-InputName=mmx_gauss_3x1
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_gauss_3x1.asm
-InputName=mmx_gauss_3x1
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_not.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_not.asm
-InputName=mmx_not
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_not.asm
-InputName=mmx_not
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_or.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_or.asm
-InputName=mmx_or
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_or.asm
-InputName=mmx_or
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_shiftleft.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_shiftleft.asm
-InputName=mmx_shiftleft
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_shiftleft.asm
-InputName=mmx_shiftleft
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_shiftright.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_shiftright.asm
-InputName=mmx_shiftright
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_shiftright.asm
-InputName=mmx_shiftright
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_subtract.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_subtract.asm
-InputName=mmx_subtract
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_subtract.asm
-InputName=mmx_subtract
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_sum.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_sum.asm
-InputName=mmx_sum
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_sum.asm
-InputName=mmx_sum
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_supported.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_supported.asm
-InputName=mmx_supported
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_supported.asm
-InputName=mmx_supported
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\mmx_xor.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\mmx_xor.asm
-InputName=mmx_xor
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\mmx_xor.asm
-InputName=mmx_xor
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\Quick.cpp
+SOURCE=.\Quick\Quick.cpp
 # End Source File
 # Begin Source File
 
 SOURCE=.\Quick\Quick.h
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\xmm_absdiff.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\xmm_absdiff.asm
-InputName=xmm_absdiff
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\xmm_absdiff.asm
-InputName=xmm_absdiff
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\xmm_and.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\xmm_and.asm
-InputName=xmm_and
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\xmm_and.asm
-InputName=xmm_and
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\xmm_const_and.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\xmm_const_and.asm
-InputName=xmm_const_and
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\xmm_const_and.asm
-InputName=xmm_const_and
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\xmm_const_diff.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\xmm_const_diff.asm
-InputName=xmm_const_diff
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\xmm_const_diff.asm
-InputName=xmm_const_diff
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\xmm_const_or.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\xmm_const_or.asm
-InputName=xmm_const_or
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\xmm_const_or.asm
-InputName=xmm_const_or
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\xmm_const_sum.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\xmm_const_sum.asm
-InputName=xmm_const_sum
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\xmm_const_sum.asm
-InputName=xmm_const_sum
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\xmm_const_xor.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\xmm_const_xor.asm
-InputName=xmm_const_xor
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\xmm_const_xor.asm
-InputName=xmm_const_xor
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\xmm_not.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\xmm_not.asm
-InputName=xmm_not
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\xmm_not.asm
-InputName=xmm_not
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\xmm_or.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\xmm_or.asm
-InputName=xmm_or
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\xmm_or.asm
-InputName=xmm_or
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\xmm_shiftleft.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\xmm_shiftleft.asm
-InputName=xmm_shiftleft
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\xmm_shiftleft.asm
-InputName=xmm_shiftleft
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\xmm_shiftright.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\xmm_shiftright.asm
-InputName=xmm_shiftright
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\xmm_shiftright.asm
-InputName=xmm_shiftright
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\xmm_subtract.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\xmm_subtract.asm
-InputName=xmm_subtract
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\xmm_subtract.asm
-InputName=xmm_subtract
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\xmm_sum.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\xmm_sum.asm
-InputName=xmm_sum
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\xmm_sum.asm
-InputName=xmm_sum
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
-# End Source File
-# Begin Source File
-
-SOURCE=.\Quick\xmm_xor.asm
-
-!IF  "$(CFG)" == "Blepo - Win32 Release"
-
-# Begin Custom Build
-OutDir=.\Release-VC6
-InputPath=.\Quick\xmm_xor.asm
-InputName=xmm_xor
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ELSEIF  "$(CFG)" == "Blepo - Win32 Debug"
-
-# Begin Custom Build
-OutDir=.\Debug-VC6
-InputPath=.\Quick\xmm_xor.asm
-InputName=xmm_xor
-
-"$(OUTDIR)\$(InputName).obj" : $(SOURCE) "$(INTDIR)" "$(OUTDIR)"
-	nasmw.exe -f win32 -o "$(OUTDIR)\$(InputName).obj" "$(InputPath)"
-
-# End Custom Build
-
-!ENDIF 
-
 # End Source File
 # End Group
 # Begin Group "Utilities"
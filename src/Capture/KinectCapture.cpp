@@ -150,7 +150,7 @@ void ColorCoordtoKinectDepth(const ImgFloat &img, CPoint &pt, float *x, float *y
 	(*z)=(float) wc(0,2);
 }
 
-void GetPointCloudFromKinectData(const ImgBgr &img, const ImgInt &depth, PointCloud *cloud, bool useZeros)
+void GetPointCloudFromKinectData(const ImgBgr &img, const ImgUShort &depth, PointCloud *cloud, bool useZeros)
 {
 	//take care of old cloud to prevent memory leak/corruption
 	if (cloud != NULL && cloud->Size() > 0) {
@@ -158,7 +158,7 @@ void GetPointCloudFromKinectData(const ImgBgr &img, const ImgInt &depth, PointCl
 	}
 	cloud->Resize(img.Width()*img.Height());
 	cloud->Set(ColoredPoint(0.0f,0.0f,0.0f,Bgr::BLACK,false));
-	ImgInt::ConstIterator pDepth = depth.Begin();
+	ImgUShort::ConstIterator pDepth = depth.Begin();
 	int safeWidth = img.Width() - 1, safeHeight = img.Height() - 1;
 	bool fullDepth = true;
 	float cx_d = (float) KINECT_CX_D, cy_d = (float) KINECT_CY_D;
@@ -337,7 +337,7 @@ void GetPointCloudFromKinectData(const ImgBgr &img, const ImgInt &depth, PointCl
 	//Depth Functions
 #pragma region Depth
 
-	bool KinectCapture::GetDepth(blepo::ImgInt *img, bool shifted)
+	bool KinectCapture::GetDepth(blepo::ImgUShort *img, bool shifted)
   {
 		if (!depthStarted)
 			StartDepthCapture();
@@ -357,7 +357,7 @@ void GetPointCloudFromKinectData(const ImgBgr &img, const ImgInt &depth, PointCl
 			BYTE * pBuffer = (BYTE*) LockedRect.pBits;
 
 			// draw the bits to the bitmap
-			blepo::ImgInt::Iterator pOut = origDepth.Begin();
+			blepo::ImgUShort::Iterator pOut = origDepth.Begin();
 			USHORT * pBufferRun = (USHORT*) pBuffer;
 			for( int y = 0 ; y < depthHeight ; y++ )
 			{
@@ -368,7 +368,7 @@ void GetPointCloudFromKinectData(const ImgBgr &img, const ImgInt &depth, PointCl
 						RealDepth = (*pBufferRun++ & 0xfff8) >> 3;
 					else
 						RealDepth = *pBufferRun++;
-					*pOut++ = (int)RealDepth;
+					*pOut++ = RealDepth;
 				}
 			}
 			if (IAmRoied)
@@ -485,7 +485,7 @@ void GetPointCloudFromKinectData(const ImgBgr &img, const ImgInt &depth, PointCl
 		return Point(int(newX),int(newY));
 	}
 
-	void KinectCapture::GetPointCloudFromData(const ImgBgr &img, const ImgInt &depth, PointCloud *cloud, bool useZeros)
+	void KinectCapture::GetPointCloudFromData(const ImgBgr &img, const ImgUShort &depth, PointCloud *cloud, bool useZeros)
   {
 		//take care of old cloud to prevent memory leak/corruption
 		if (cloud != NULL && cloud->Size() > 0) {
@@ -493,7 +493,7 @@ void GetPointCloudFromKinectData(const ImgBgr &img, const ImgInt &depth, PointCl
 		}
 		cloud->Resize(img.Width()*img.Height());
 		cloud->Set(ColoredPoint(0.0f,0.0f,0.0f,Bgr::BLACK,false));
-		ImgInt::ConstIterator pDepth = depth.Begin();
+		ImgUShort::ConstIterator pDepth = depth.Begin();
 		int safeWidth = img.Width() - 1, safeHeight = img.Height() - 1;
 		float cx_d = (float) KINECT_CX_D, cy_d = (float) KINECT_CY_D;
 		if(!fullDepth) {
@@ -538,12 +538,12 @@ void GetPointCloudFromKinectData(const ImgBgr &img, const ImgInt &depth, PointCl
 	}
 
 	void KinectCapture::GetPointCloud(PointCloud *cloud, bool useZeros) {
-		ImgInt depth;
+		ImgUShort depth;
 		ImgBgr img;
 		GetData(&img,&depth,cloud, useZeros);
 	}
 
-	void KinectCapture::GetData(blepo::ImgBgr *img, blepo::ImgInt *depth, PointCloud *cloud, bool useZeros) {
+	void KinectCapture::GetData(blepo::ImgBgr *img, blepo::ImgUShort *depth, PointCloud *cloud, bool useZeros) {
 		int attempts = 0; //give ten tries, sometimes is necessary on startup or if code is running really fast?
 		//this number is temporary, should put a timer with 100 ms or so here.
 		int totAttempts = 10000;
@@ -96,7 +96,7 @@ namespace blepo
 	#define KINECT_T3 -1.0916736334336222e-02
 	
 	//I'm putting these functions outside of the kinect class so you don't have to have a kinect plugged in
-	void GetPointCloudFromKinectData(const ImgBgr &img, const ImgInt &depth, PointCloud *cloud, bool useZeros);
+	void GetPointCloudFromKinectData(const ImgBgr &img, const ImgUShort &depth, PointCloud *cloud, bool useZeros);
 	inline Point KinectDepthToColorCoord(const ImgBgr &img, float x, float y, float z);
 	void ColorCoordtoKinectDepth(const ImgFloat &img, CPoint &pt, float *x, float *y, float *z);
 
@@ -127,7 +127,7 @@ namespace blepo
 		Rect m_roi;
 		bool IAmRoied;
 		ImgBgr origImg, depthwPerson;
-		ImgInt origDepth;
+		ImgUShort origDepth;
 		bool useMicrosoftMapping;
 
 	public:
@@ -156,7 +156,7 @@ namespace blepo
 			IAmRoied = false;
 		};
 
-		void ClearRoiAndGetOldData(ImgBgr *img, ImgInt *depth) 
+		void ClearRoiAndGetOldData(ImgBgr *img, ImgUShort *depth) 
 		{
 			m_roi = Rect(0,0,640,480);
 			IAmRoied = false;
@@ -176,7 +176,7 @@ namespace blepo
 		//            (units would be millimeters if shifted to the right by 3 bits)
 		// shifted == true means depth values have been shifted right by 3 bits to remove person information
 		//            (units are millimeters)
-		bool GetDepth(blepo::ImgInt *img, bool shifted = true);
+		bool GetDepth(blepo::ImgUShort *img, bool shifted = true);
 
 		bool GetDepthAndPerson(blepo::ImgBgr *img);
 
@@ -187,11 +187,11 @@ namespace blepo
 
 		//x and y should be the depth indices, z should be the depth in meters (what the point cloud gives you)
 		Point GetImageDataFromDepthData(int x, int y, float z);
-		void GetPointCloudFromData(const ImgBgr &img, const ImgInt &depth, PointCloud *cloud, bool useZeros = false);
+		void GetPointCloudFromData(const ImgBgr &img, const ImgUShort &depth, PointCloud *cloud, bool useZeros = false);
 
 		void GetPointCloud(PointCloud *cloud, bool useZeros = false);
 		
-		void GetData(blepo::ImgBgr *img, blepo::ImgInt *depth, PointCloud *cloud, bool useZeros = false);
+		void GetData(blepo::ImgBgr *img, blepo::ImgUShort *depth, PointCloud *cloud, bool useZeros = false);
 		
 		//void GetData(blepo::ImgBgr *img, blepo::ImgInt *depth, PointCloud *cloud); //for skeleton and other stuff
 		//void GetData(blepo::ImgBgr *img, blepo::ImgInt *depth, PointCloud *cloud);
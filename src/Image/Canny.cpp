@@ -1,227 +1,261 @@
-/* 
- * Copyright (c) 2005 Clemson University.
- *
- * This program is free software; you can redistribute it and/or modify
- * it under the terms of the GNU General Public License as published by
- * the Free Software Foundation; either version 2 of the License, or (at
- * your option) any later version.
- * 
- * This program is distributed in the hope that it will be useful, but
- * WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
- * General Public License for more details.
- * 
- * You should have received a copy of the GNU General Public License
- * along with this program; if not, write to the Free Software
- * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
- */
-
-#include "ImageAlgorithms.h"
-#include "ImageOperations.h"
-#include "Figure/Figure.h"
-#include "Utilities/Math.h"
-#include <math.h>  // sqrt, atan2
-#include <algorithm> // std::sort()
-#include <functional> // std::greater
-
-// -------------------- all includes must go before these lines ------------------
-#if defined(DEBUG) && defined(WIN32) && !defined(NO_MFC)
-#include <afxwin.h>
-#define new DEBUG_NEW
-#undef THIS_FILE
-static char THIS_FILE[] = __FILE__;
-#endif
-// -------------------- all code must go after these lines -----------------------
-
-// ================> begin local functions (available only to this translation unit)
-namespace
-{
-using namespace blepo;
-
-// operates in place:
-//   'x_mag'  :  gradx (input) and magnitude (output)
-//   'y_phase':  grady (input) and phase (output)
-void ComputeMagnitudeAndPhase(ImgFloat* x_mag, ImgFloat* y_phase)
-{
-  assert(IsSameSize(*x_mag, *y_phase));
-
-  ImgFloat::Iterator px = x_mag->Begin();
-  ImgFloat::Iterator py = y_phase->Begin();
-
-  while (px != x_mag->End())
-  {
-    float mag = sqrt(*px * *px + *py * *py);
-    float phase = atan2(*py, *px);
-    *px++ = mag;
-    *py++ = phase;
-  }
-}
-
-// returns the offset pixel in the direction of the gradient (module 180 degrees)
-inline void GetDirection(float phase, int* dx, int* dy)
-{
-  if (phase < 0)  phase += (float) blepo_ex::Pi;  // ignore sign of gradient
-
-  double pi8 = blepo_ex::Pi / 8;
-  
-  if      (phase <     pi8)  { *dx = 1;  *dy =  0; }
-  else if (phase < 3 * pi8)  { *dx = 1;  *dy =  1; }
-  else if (phase < 5 * pi8)  { *dx = 0;  *dy =  1; }
-  else if (phase < 7 * pi8)  { *dx = 1;  *dy = -1; }
-  else                       { *dx = 1;  *dy =  0; }
-}
-
-void NonMaximumSuppression(const ImgFloat& mag, const ImgFloat& phase, ImgFloat* out)
-{
-  assert(IsSameSize(mag, phase));
-  out->Reset(mag.Width(), mag.Height());
-  Set(out, 0);  // only for borders
-
-  int dx, dy;
-  for (int y = 1 ; y < mag.Height()-1 ; y++)
-  {
-    for (int x = 1 ; x < mag.Width()-1 ; x++)
-    {
-      GetDirection( phase(x, y), &dx, &dy );
-      float val0 = mag(x, y);
-      float val1 = mag(x+dx, y+dy);
-      float val2 = mag(x-dx, y-dy);
-      (*out)(x, y) = (val0 >= val1 && val0 >= val2) ? val0 : 0;
-    }
-  }
-}
-
-// returns true if there are any (non-zero) edge pixels in 'edges'
-bool DetermineThresholds(const ImgFloat& edges, float perc, float ratio, 
-                         float* th_low, float* th_high)
-{
-  assert(perc > 0.0f && perc < 1.0f);
-  assert(ratio > 1.0f);
-
-  // store all gradient values in a vector
-  std::vector<float> vals;
-  const float* p = edges.Begin();
-  for ( ; p != edges.End() ; p++)
-  {
-    if (*p != 0)  vals.push_back(*p);
-  }
-
-  if (vals.size() > 0)
-  {
-    // sort ascending
-    std::sort( vals.begin(), vals.end() );
-
-    // compute thresholds as a function of 'perc' and 'ratio'
-    int npix = vals.size();
-    int index = blepo_ex::Clamp( blepo_ex::Round( perc * npix ), 0, npix-1 );
-    *th_high = vals[index];
-    *th_low = *th_high / ratio;
-    return true;
-  }
-  else
-  { // there are no edge pixels
-    *th_low = *th_high = 1;
-    return false;
-  }
-}
-
-inline void Expand(const ImgFloat& edges, float th, std::vector<Point>* frontier, const Point& p, ImgBinary* out)
-{
-  ImgBinary::PixelRef pix = (*out)(p.x, p.y);
-  if ( edges(p.x, p.y) >= th && !pix)
-  {
-    frontier->push_back(p);
-    pix = 1;
-  }
-}
-
-void DoubleThreshold(const ImgFloat& img, float th_low, float th_high, ImgBinary* out)
-{
-  out->Reset(img.Width(), img.Height());
-  Set(out, 0);  // only for borders
-
-  std::vector<Point> frontier;
-  int w = img.Width()-1;
-  int h = img.Height()-1;
-  Point p;
-
-  for (int y = 0 ; y < img.Height() ; y++)
-  {
-    for (int x = 0 ; x < img.Width() ; x++)
-    {
-      if ( img(x, y) >= th_high )  
-      {
-        frontier.push_back(Point(x, y));
-        (*out)(x, y) = 1;
-      }
-    }
-  }
-
-  while (frontier.size() != 0)
-  {
-    p = frontier.back();
-    frontier.pop_back();
-
-    if (p.x > 0)  Expand(img, th_low, &frontier, Point(p.x-1, p.y  ), out);
-    if (p.x < w)  Expand(img, th_low, &frontier, Point(p.x+1, p.y  ), out);
-    if (p.y > 0)  Expand(img, th_low, &frontier, Point(p.x,   p.y-1), out);
-    if (p.y < h)  Expand(img, th_low, &frontier, Point(p.x,   p.y+1), out);
-    
-    if (p.x > 0 && p.y > 0)  Expand(img, th_low, &frontier, Point(p.x-1, p.y-1), out);
-    if (p.x > 0 && p.y < h)  Expand(img, th_low, &frontier, Point(p.x-1, p.y+1), out);
-    if (p.x < w && p.y > 0)  Expand(img, th_low, &frontier, Point(p.x+1, p.y-1), out);
-    if (p.x < w && p.y < h)  Expand(img, th_low, &frontier, Point(p.x+1, p.y+1), out);
-  }
-}
-
-};
-// ================< end local functions
-
-namespace blepo
-{
-
-void Canny(const ImgGray& img, ImgBinary* out, float sigma, float perc, float ratio)
-{
-  ImgFloat fimg, gradx, grady, edges;
-  ImgFloat &mag = gradx, &phase = grady;
-  float th_low, th_high;
-//  Figure fig1("gradx"), fig2("grady"), fig3("mag"), fig4("phase"), fig5("nonmax");
-
-  // compute gradient
-  Convert(img, &fimg);
-  if (sigma == -1)
-  {
-    GradientSobel(fimg, &gradx, &grady);
-  } else if (sigma == -2)
-  {
-    ImgFloat tmp_smoothed, &tmp = edges;
-    FastSmoothAndGradientApprox(fimg, &tmp_smoothed, &gradx, &grady, &tmp);
-  }
-  else
-  {
-    assert( sigma > 0 );
-    Gradient(fimg, sigma, &gradx, &grady);
-  }
-//  fig1.Draw(gradx);
-//  fig2.Draw(grady);
-  ComputeMagnitudeAndPhase(&mag, &phase);
-
-//  fig3.Draw(mag);
-//  fig4.Draw(phase);
-
-  // non-maximum suppression
-  NonMaximumSuppression(mag, phase, &edges);
-
-//  fig5.Draw(edges);
-
-  // threshold
-  bool any_edges = DetermineThresholds(edges, perc, ratio, &th_low, &th_high);
-  if (any_edges)
-  {
-    DoubleThreshold(edges, th_low, th_high, out);
-  }
-}
-
-
-};  // end namespace blepo
-
+/* 
+ * Copyright (c) 2005 Clemson University.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "ImageAlgorithms.h"
+#include "ImageOperations.h"
+#include "Figure/Figure.h"
+#include "Utilities/Math.h"
+#include <math.h>  // sqrt
+#include <string.h>  // memcpy
+#include <vector>
+
+// -------------------- all includes must go before these lines ------------------
+#if defined(DEBUG) && defined(WIN32) && !defined(NO_MFC)
+#include <afxwin.h>
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif
+// -------------------- all code must go after these lines -----------------------
+
+// ================> begin local functions (available only to this translation unit)
+namespace
+{
+using namespace blepo;
+
+// returns the offset pixel in the direction of the gradient (gx, gy), modulo 180 degrees, 
+// in bins of 45 degrees centered on the axes and diagonals.  With gy folded to be non-negative,
+// the gradient is within 22.5 degrees of horizontal when gy < tan(22.5) |gx|, and of vertical 
+// when |gx| <= tan(22.5) gy, so that no atan2 is needed.
+inline void GetDirection(float gx, float gy, int* dx, int* dy)
+{
+  const float tan_pi8 = 0.41421356f;
+  if (gy < 0)  { gx = -gx;  gy = -gy; }  // ignore sign of gradient
+  const float ax = (gx < 0) ? -gx : gx;
+
+  if      (gy < tan_pi8 * ax)  { *dx = 1;  *dy =  0; }
+  else if (ax <= tan_pi8 * gy) { *dx = 0;  *dy =  1; }
+  else if (gx > 0)             { *dx = 1;  *dy =  1; }
+  else                         { *dx = 1;  *dy = -1; }
+}
+
+// Fixed-bin histogram of the suppressed magnitudes, for DetermineThresholds().  The bin of a
+// magnitude is the top bits of its IEEE representation, which increases with the value for 
+// non-negative floats:  8 bits of mantissa, so that a bin is less than 0.4% wide, over the 
+// 32 octaves from 2^-16 to 2^16 (smaller and larger magnitudes go into the end bins).
+const int iMAG_BIN_SHIFT = 15;
+const int iMAG_BIN_FIRST = (127 - 16) << 8;  // bin of 2^-16
+const int iMAG_NBINS = 32 << 8;
+
+inline int iMagnitudeBin(float mag)
+{
+  unsigned int bits;
+  memcpy(&bits, &mag, sizeof(bits));
+  return blepo_ex::Clamp((int) (bits >> iMAG_BIN_SHIFT) - iMAG_BIN_FIRST, 0, iMAG_NBINS - 1);
+}
+
+// smallest magnitude in bin 'bin'
+inline float iMagnitudeOfBin(int bin)
+{
+  const unsigned int bits = ((unsigned int) (bin + iMAG_BIN_FIRST)) << iMAG_BIN_SHIFT;
+  float mag;
+  memcpy(&mag, &bits, sizeof(mag));
+  return mag;
+}
+
+// Computes the gradient magnitude, the direction and the non-maximum suppression in one pass 
+// over the rows.  The magnitudes go into a ring of three rows, and row y-1 is suppressed as soon 
+// as row y is in the ring.  Operates in place:
+//   'gradx_edges':  gradx (input) and suppressed magnitude (output, zero on the border)
+// The non-zero suppressed magnitudes are also counted in 'hist', for DetermineThresholds().
+void NonMaximumSuppression(ImgFloat* gradx_edges, const ImgFloat& grady, ImgInt* hist)
+{
+  assert(IsSameSize(*gradx_edges, grady));
+  assert(hist->Width() == iMAG_NBINS && hist->Height() == 1);
+  const int w = grady.Width(), h = grady.Height();
+  Set(hist, 0);
+  if (w < 3 || h < 3)  { Set(gradx_edges, 0);  return; }
+  ImgInt::Iterator counts = hist->Begin();
+
+  ImgFloat ring(w, 3, FrameArena::GetDefault());
+  int dx, dy;
+  for (int y = 0 ; y <= h ; y++)
+  {
+    if (y < h)
+    {
+      const ImgFloat& gradx = *gradx_edges;
+      ImgFloat::ConstIterator px = gradx.Begin(0, y), py = grady.Begin(0, y);
+      ImgFloat::Iterator mag = ring.Begin(0, y % 3);
+      for (int x = 0 ; x < w ; x++)  mag[x] = sqrt(px[x] * px[x] + py[x] * py[x]);
+    }
+
+    const int yc = y - 1;
+    if (yc < 1 || yc >= h - 1)  continue;
+    ImgFloat::ConstIterator above = ring.Begin(0, (yc - 1) % 3), row = ring.Begin(0, yc % 3), below = ring.Begin(0, (yc + 1) % 3);
+    ImgFloat::ConstIterator py = grady.Begin(0, yc);
+    ImgFloat::Iterator q = gradx_edges->Begin(0, yc);  // gradx is read at each pixel before it is overwritten
+    for (int x = 1 ; x < w - 1 ; x++)
+    {
+      GetDirection( q[x], py[x], &dx, &dy );
+      ImgFloat::ConstIterator fwd = row, back = row;  // rows of (x+dx, y+dy) and (x-dx, y-dy)
+      if      (dy > 0)  { fwd = below;  back = above; }
+      else if (dy < 0)  { fwd = above;  back = below; }
+      const float val0 = row[x];
+      const float val1 = fwd[x + dx];
+      const float val2 = back[x - dx];
+      q[x] = (val0 >= val1 && val0 >= val2) ? val0 : 0;
+      if (q[x] != 0)  counts[ iMagnitudeBin(q[x]) ]++;
+    }
+    q[0] = q[w - 1] = 0;
+  }
+  Set(gradx_edges, 0, 0, 0, w);
+  Set(gradx_edges, 0, 0, h - 1, w);
+}
+
+// returns true if there are any (non-zero) edge pixels in 'hist', the histogram of the
+// suppressed magnitudes (one row of bins).  The high threshold is the smallest magnitude 
+// in the bin of the 'perc' quantile, found in one pass over the bins.
+bool DetermineThresholds(const ImgInt& hist_img, float perc, float ratio, 
+                         float* th_low, float* th_high)
+{
+  assert(perc > 0.0f && perc < 1.0f);
+  assert(ratio > 1.0f);
+
+  const int nbins = hist_img.Width();
+  ImgInt::ConstIterator hist = hist_img.Begin();
+  int npix = 0, b;
+  for (b = 0 ; b < nbins ; b++)  npix += hist[b];
+
+  if (npix > 0)
+  {
+    // compute thresholds as a function of 'perc' and 'ratio'
+    int index = blepo_ex::Clamp( blepo_ex::Round( perc * npix ), 0, npix-1 );
+    int below = 0;
+    for (b = 0 ; below + hist[b] <= index ; b++)  below += hist[b];
+    *th_high = iMagnitudeOfBin(b);
+    *th_low = *th_high / ratio;
+    return true;
+  }
+  else
+  { // there are no edge pixels
+    *th_low = *th_high = 1;
+    return false;
+  }
+}
+
+// Hysteresis thresholding.  One pass classifies the pixels into an 8-bit state
+// (0: below 'th_low', 1: candidate, 2: edge) and seeds the frontier with the pixels at or 
+// above 'th_high'; the candidates 8-connected to an edge are then grown into edges, 
+// reading one byte per neighbor.
+void DoubleThreshold(const ImgFloat& img, float th_low, float th_high, ImgBinary* out)
+{
+  enum { BELOW = 0, CANDIDATE = 1, EDGE = 2 };
+  const int w = img.Width(), h = img.Height();
+  ImgGray state(w, h, FrameArena::GetDefault());
+  std::vector<Point> frontier;
+
+  for (int y = 0 ; y < h ; y++)
+  {
+    ImgFloat::ConstIterator p = img.Begin(0, y);
+    ImgGray::Iterator s = state.Begin(0, y);
+    for (int x = 0 ; x < w ; x++)
+    {
+      if ( p[x] >= th_high )
+      {
+        frontier.push_back(Point(x, y));
+        s[x] = EDGE;
+      }
+      else  s[x] = (p[x] >= th_low) ? CANDIDATE : BELOW;
+    }
+  }
+
+  while (frontier.size() != 0)
+  {
+    const Point p = frontier.back();
+    frontier.pop_back();
+
+    const int x0 = blepo_ex::Max(p.x - 1, 0), x1 = blepo_ex::Min(p.x + 1, w - 1);
+    const int y0 = blepo_ex::Max(p.y - 1, 0), y1 = blepo_ex::Min(p.y + 1, h - 1);
+    for (int y = y0 ; y <= y1 ; y++)
+    {
+      ImgGray::Iterator s = state.Begin(0, y);
+      for (int x = x0 ; x <= x1 ; x++)
+      {
+        if (s[x] == CANDIDATE)
+        {
+          frontier.push_back(Point(x, y));
+          s[x] = EDGE;
+        }
+      }
+    }
+  }
+
+  Equal(state, (ImgGray::Pixel) EDGE, out);
+}
+
+};
+// ================< end local functions
+
+namespace blepo
+{
+
+void Canny(const ImgGray& img, ImgBinary* out, float sigma, float perc, float ratio)
+{
+  // temporaries come from the thread's frame arena, if there is one
+  FrameArena* arena = FrameArena::GetDefault();
+  const int w = img.Width(), h = img.Height();
+  ImgFloat fimg(w, h, arena), gradx(w, h, arena), grady(w, h, arena);
+  ImgFloat &edges = gradx;
+  ImgInt hist(iMAG_NBINS, 1, arena);
+  float th_low, th_high;
+//  Figure fig1("gradx"), fig2("grady"), fig5("nonmax");
+
+  // compute gradient
+  Convert(img, &fimg);
+  if (sigma == -1)
+  {
+    GradientSobel(fimg, &gradx, &grady);
+  } else if (sigma == -2)
+  {
+    ImgFloat tmp_smoothed, tmp(w, h, arena);
+    FastSmoothAndGradientApprox(fimg, &tmp_smoothed, &gradx, &grady, &tmp);
+  }
+  else
+  {
+    assert( sigma > 0 );
+    Gradient(fimg, sigma, &gradx, &grady);
+  }
+//  fig1.Draw(gradx);
+//  fig2.Draw(grady);
+
+  // magnitude, direction and non-maximum suppression, in one pass
+  NonMaximumSuppression(&gradx, grady, &hist);
+
+//  fig5.Draw(edges);
+
+  // threshold
+  bool any_edges = DetermineThresholds(hist, perc, ratio, &th_low, &th_high);
+  if (any_edges)
+  {
+    DoubleThreshold(edges, th_low, th_high, out);
+  }
+}
+
+
+};  // end namespace blepo
+
@@ -307,29 +307,26 @@ void iBuildDepthGraph(const ImgFloat& smooth_r,
 }
 
 
+// Each channel goes through an ImgGray plane, which is split off with SIMD, and 
+// then to float with a plain contiguous loop
+void iExtractRGBColorSpace(const ImgBgrPlanar& img, 
+					   ImgFloat* B, 
+					   ImgFloat* G,
+					   ImgFloat* R)
+{
+  Convert(img.B(), B);
+  Convert(img.G(), G);
+  Convert(img.R(), R);
+}
+
 void iExtractRGBColorSpace(const ImgBgr& img, 
 					   ImgFloat* B, 
 					   ImgFloat* G,
 					   ImgFloat* R)
 {
-  const int ISIZEX = img.Width(), ISIZEY = img.Height();
-	const unsigned char *ptri = img.BytePtr();
-	float *ptr1 = B->Begin();
-  float *ptr2 = G->Begin();
-	float *ptr3 = R->Begin();
-	int b, g ,r;
-	int i;
-
-	for (i=0 ; i<ISIZEX*ISIZEY ; i++)
-  {
-		b = *ptri++;
-		g = *ptri++;
-		r = *ptri++;
-
-		*ptr1++ = (float)b;
-		*ptr2++ = (float)g;
-		*ptr3++ = (float)r;
-	}
+  ImgBgrPlanar planar;
+  Convert(img, &planar);
+  iExtractRGBColorSpace(planar, B, G, R);
 }
 
 void iSmooth(const ImgFloat &src, float sigma, ImgFloat *out)
@@ -418,6 +415,19 @@ int FHGraphSegmentation(
         int min_size,
         ImgInt *out_labels, 
         ImgBgr *out_pseudocolors) 
+{
+  ImgBgrPlanar planar;
+  Convert(img, &planar);
+  return FHGraphSegmentation(planar, sigma, c, min_size, out_labels, out_pseudocolors);
+}
+
+int FHGraphSegmentation(
+        const ImgBgrPlanar& img, 
+        float sigma, 
+        float c, 
+        int min_size,
+        ImgInt *out_labels, 
+        ImgBgr *out_pseudocolors) 
 {
   int width = img.Width();
   int height = img.Height();
@@ -472,9 +482,10 @@ int FHGraphSegmentation(
   return num_ccs;
 }
 
-int FHGraphSegmentDepth(
+// 'D' is the depth image, converted to floating point
+int iFHGraphSegmentDepth(
         const ImgBgr& img, 
-        const ImgGray& depth,
+        const ImgFloat& D,
         float sigma, 
         float c, 
         int min_size,
@@ -488,10 +499,9 @@ int FHGraphSegmentDepth(
   ImgFloat R(width, height),G(width, height),B(width, height);
   iExtractRGBColorSpace(img, &B, &G, &R);
   ImgFloat smooth_R(width, height), smooth_G(width, height), smooth_B(width, height);
-  ImgFloat D(width, height), smooth_D(width, height);
+  ImgFloat smooth_D(width, height);
   out_labels->Reset(width, height);
   out_pseudocolors->Reset(width, height);
-  Convert(depth,&D);
   iSmooth(B, sigma, &smooth_B);
   iSmooth(G, sigma, &smooth_G);
   iSmooth(R, sigma, &smooth_R);
@@ -537,6 +547,20 @@ int FHGraphSegmentDepth(
   return num_ccs;
 }
 
+int FHGraphSegmentDepth(const ImgBgr& img, const ImgGray& depth, float sigma, float c, int min_size, ImgInt *out_labels, ImgBgr *out_pseudocolors) 
+{
+  ImgFloat D;
+  Convert(depth, &D);
+  return iFHGraphSegmentDepth(img, D, sigma, c, min_size, out_labels, out_pseudocolors);
+}
+
+int FHGraphSegmentDepth(const ImgBgr& img, const ImgUShort& depth, float sigma, float c, int min_size, ImgInt *out_labels, ImgBgr *out_pseudocolors) 
+{
+  ImgFloat D;
+  Convert(depth, &D);
+  return iFHGraphSegmentDepth(img, D, sigma, c, min_size, out_labels, out_pseudocolors);
+}
+
 // 'inplace' is okay
 void RemoveGapsFromLabelImage(const ImgInt& labels, ImgInt* out)
 {
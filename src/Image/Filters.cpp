@@ -1,138 +1,246 @@
-/* 
- * Copyright (c) 2005 Clemson University.
- *
- * This program is free software; you can redistribute it and/or modify
- * it under the terms of the GNU General Public License as published by
- * the Free Software Foundation; either version 2 of the License, or (at
- * your option) any later version.
- * 
- * This program is distributed in the hope that it will be useful, but
- * WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
- * General Public License for more details.
- * 
- * You should have received a copy of the GNU General Public License
- * along with this program; if not, write to the Free Software
- * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
- */
-
-#include "Image.h"
-
-// -------------------- all includes must go before these lines ------------------
-#if defined(DEBUG) && defined(WIN32) && !defined(NO_MFC)
-#include <afxwin.h>
-#define new DEBUG_NEW
-#undef THIS_FILE
-static char THIS_FILE[] = __FILE__;
-#endif
-// -------------------- all code must go after these lines -----------------------
-
-
-namespace blepo
-{
-
-// Median filters written by Prashanth Y. Govindaraju and Ramakrishnan Ravindran, 2005
-
-// Median Filter for gray scale images
-void MedianFilter(const ImgGray& img,  const int kernel_width,const int kernel_height, ImgGray* out)
-{
-	int count=0;
-	out->Reset(img.Width(), img.Height());            //Reset output image to same size as input
-	const int height=img.Height();
-	const int width=img.Width();
-	ImgInt median_array;
-	median_array.Reset(kernel_width*kernel_height,1); //Temprary array used for sorting		
-	int min,median_value,temp;
-	int x_cor;
-	int y_cor;
-	int k;
-	for(int i=0;i<width-1;i++)
-		for(int j=0;j<height-1;j++)
-		{
-			
-			count=0;
-			for(int x=-(kernel_width)/2;x<=(kernel_width)/2;x++)	//Collecting values within the kernel
-				for(int y=-(kernel_height)/2;y<=(kernel_height)/2;y++)
-				{
-					
-					x_cor=i+x;
-					y_cor=j+y;
-					if((x_cor)<0) x_cor=0;
-					if((y_cor)<0) y_cor=0;
-					if(x_cor>width-1) x_cor=width-2;
-					if(y_cor>height-1) y_cor=height-2;
-					median_array(count,0)=img(x_cor,y_cor);
-					count++;
-				}
-				min=median_array(0,0);
-				k=0;
-				while(k<count-1)	//Sorting the kernel pixel values
-				{
-					if(median_array(k,0)> median_array(k+1,0))
-					{
-						temp=median_array(k,0);
-						median_array(k,0)=median_array(k+1,0);
-						median_array(k+1,0)=temp;
-						k=-1;
-					}
-					k++;
-					
-				}
-				median_value=median_array((count+1)/2,0);	//Finding the Median
-				*(out->Begin(i,j))=median_value;
-		}
-}
-
-// Median filter for integer images
-
-void MedianFilter(const ImgInt& img,  const int kernel_width,const int kernel_height, ImgInt* out)
-{
-	int count=0;
-	out->Reset(img.Width(), img.Height());              //Reset output image to same size as input
-	const int height=img.Height();
-	const int width=img.Width();
-	ImgInt median_array;
-    median_array.Reset(kernel_width*kernel_height,1);  //Temprary array used for sorting
-	int min,median_value,temp;
-	int x_cor;
-	int y_cor;
-	int k;
-	for(int i=0;i<width-1;i++)
-		for(int j=0;j<height-1;j++)
-		{
-			
-			count=0;
-			for(int x=-kernel_width/2;x<=kernel_width/2;x++)	//Collecting values within the kernel
-				for(int y=-kernel_height/2;y<=kernel_height/2;y++)
-				{
-					
-					x_cor=i+x;
-					y_cor=j+y;
-					if((x_cor)<0) x_cor=0;
-					if((y_cor)<0) y_cor=0;
-					if(x_cor>width-1) x_cor=width-2;
-					if(y_cor>height-1) y_cor=height-2;
-					median_array(count,0)=img(x_cor,y_cor);
-					count++;
-				}
-				min=median_array(0,0);
-				k=0;
-				while(k<count-1)	//Sorting the kernel pixel values
-				{
-					if(median_array(k,0)> median_array(k+1,0))
-					{
-						temp=median_array(k,0);
-						median_array(k,0)=median_array(k+1,0);
-						median_array(k+1,0)=temp;
-						k=-1;
-					}
-					k++;
-					
-				}
-				median_value=median_array((count+1)/2,0);	//Finding the Median
-				*(out->Begin(i,j))=median_value;
-		}
-}
-
-};  // end namespace blepo
-
+/* 
+ * Copyright (c) 2005 Clemson University.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Image.h"
+#include "ImageOperations.h"
+#include "SlidingHistogram.h"
+#include "Quick/Quick.h"  // CanDoSse2
+#include "Utilities/Exception.h"
+#include "Utilities/Math.h"
+#include <algorithm>  // std::nth_element
+#include <vector>
+#if defined(_MSC_VER) || defined(__SSE2__)
+#include <emmintrin.h>  // SSE2 intrinsics
+#define BLEPO_SSE2_INTRINSICS
+#endif
+
+// -------------------- all includes must go before these lines ------------------
+#if defined(DEBUG) && defined(WIN32) && !defined(NO_MFC)
+#include <afxwin.h>
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif
+// -------------------- all code must go after these lines -----------------------
+
+
+namespace blepo
+{
+
+// Median filters originally written by Prashanth Y. Govindaraju and Ramakrishnan Ravindran, 2005
+
+// ================> begin local functions (available only to this file)
+namespace
+{
+
+// ---------------- median of 3x3 and 5x5 windows with sorting networks
+// The networks (Paeth; Devillard) leave the median of 9 (resp. 25) values in 
+// p[4] (resp. p[12]).  They are written for any type with iMin / iMax, so that 
+// the same code sorts 16 pixels at once in SSE2 registers or one pixel at a time.
+
+inline unsigned char iMin(unsigned char a, unsigned char b) { return a < b ? a : b; }
+inline unsigned char iMax(unsigned char a, unsigned char b) { return a < b ? b : a; }
+#ifdef BLEPO_SSE2_INTRINSICS
+inline __m128i iMin(__m128i a, __m128i b) { return _mm_min_epu8(a, b); }
+inline __m128i iMax(__m128i a, __m128i b) { return _mm_max_epu8(a, b); }
+#endif
+
+template <typename V>
+inline void iSort2(V* p, int a, int b)
+{
+  V t = iMin(p[a], p[b]);
+  p[b] = iMax(p[a], p[b]);
+  p[a] = t;
+}
+
+template <typename V>
+inline V iMedian9(V* p)
+{
+  static const unsigned char net[][2] = { 
+    {1,2},{4,5},{7,8},{0,1},{3,4},{6,7},{1,2},{4,5},{7,8},{0,3},{5,8},{4,7},{3,6},{1,4},{2,5},{4,7},{4,2},{6,4},{4,2} 
+  };
+  for (int k=0 ; k<(int) (sizeof(net)/sizeof(net[0])) ; k++)  iSort2(p, net[k][0], net[k][1]);
+  return p[4];
+}
+
+template <typename V>
+inline V iMedian25(V* p)
+{
+  static const unsigned char net[][2] = {
+    {0,1},{3,4},{2,4},{2,3},{6,7},{5,7},{5,6},{9,10},{8,10},{8,9},{12,13},{11,13},{11,12},{15,16},{14,16},{14,15},
+    {18,19},{17,19},{17,18},{21,22},{20,22},{20,21},{23,24},{2,5},{3,6},{0,6},{0,3},{4,7},{1,7},{1,4},{11,14},{8,14},
+    {8,11},{12,15},{9,15},{9,12},{13,16},{10,16},{10,13},{20,23},{17,23},{17,20},{21,24},{18,24},{18,21},{19,22},{8,17},{9,18},
+    {0,18},{0,9},{10,19},{1,19},{1,10},{11,20},{2,20},{2,11},{12,21},{3,21},{3,12},{13,22},{4,22},{4,13},{14,23},{5,23},
+    {5,14},{15,24},{6,24},{6,15},{7,16},{7,19},{13,21},{15,23},{7,13},{7,15},{1,9},{3,11},{5,17},{11,17},{9,17},{4,10},
+    {6,12},{7,14},{4,6},{4,7},{12,14},{10,14},{6,7},{10,12},{6,10},{6,17},{12,17},{7,17},{7,10},{12,18},{7,12},{10,18},
+    {12,20},{10,20},{10,12}
+  };
+  for (int k=0 ; k<(int) (sizeof(net)/sizeof(net[0])) ; k++)  iSort2(p, net[k][0], net[k][1]);
+  return p[12];
+}
+
+// Median of the (2r+1)x(2r+1) window around each pixel, r = 1 or 2, with the image
+// extended by replicating its border pixels.  Each row of the image is copied into a 
+// buffer with r extra pixels on either side, so that the windows never leave the buffer.
+void iMedianNetwork(const ImgGray& img, int r, ImgGray* out)
+{
+  const int w = img.Width(), h = img.Height(), n = 2*r + 1, pw = w + 2*r;
+  std::vector<unsigned char> padded(h * pw);
+  for (int y=0 ; y<h ; y++)
+  {
+    unsigned char* q = &padded[y * pw];
+    ImgGray::ConstIterator p = img.Begin(0, y);
+    for (int x=0 ; x<pw ; x++)  q[x] = p[ blepo_ex::Clamp(x - r, 0, w - 1) ];
+  }
+  for (int y=0 ; y<h ; y++)
+  {
+    const unsigned char* rows[5];
+    for (int j=0 ; j<n ; j++)  rows[j] = &padded[ blepo_ex::Clamp(y + j - r, 0, h - 1) * pw ];
+    ImgGray::Iterator q = out->Begin(0, y);
+    int x = 0;
+#ifdef BLEPO_SSE2_INTRINSICS
+    if (blepo::CanDoSse2())
+    {
+      __m128i v[25];
+      for ( ; x+16 <= w ; x+=16)
+      {
+        for (int j=0 ; j<n ; j++)
+          for (int i=0 ; i<n ; i++)  v[j*n + i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[j] + x + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(q + x), (r == 1) ? iMedian9(v) : iMedian25(v));
+      }
+    }
+#endif
+    unsigned char v[25];
+    for ( ; x<w ; x++)
+    {
+      for (int j=0 ; j<n ; j++)
+        for (int i=0 ; i<n ; i++)  v[j*n + i] = rows[j][x + i];
+      q[x] = (r == 1) ? iMedian9(v) : iMedian25(v);
+    }
+  }
+}
+
+// ---------------- median of any window with a sliding histogram
+
+template <typename T>
+struct iPixels
+{
+  const Image<T>* img;
+  int operator()(int x, int y) const { return (*img)(x, y); }
+};
+
+template <typename T>
+struct iMedianOfWindow
+{
+  typename Image<T>::Iterator out;  // first pixel of the output
+  int stride;
+  int rank;
+  void operator()(int x, int y, SlidingHistogram& hist) { out[y*stride + x] = static_cast<T>(hist.Select(rank)); }
+};
+
+// Median of the (2rx+1)x(2ry+1) window around each pixel, with the image extended by
+// replicating its border pixels.  The pixels of 'img' are bin indices in [0, nbins).
+template <typename T, typename U>
+void iMedianHistogram(const Image<T>& img, int rx, int ry, int nbins, Image<U>* out)
+{
+  iPixels<T> pixels = { &img };
+  iMedianOfWindow<U> median = { out->Begin(), out->Stride(), (2*rx + 1) * (2*ry + 1) / 2 };
+  SlidingHistogram hist(nbins);
+  hist.Slide(pixels, img.Width(), img.Height(), rx, ry, Rect(0, 0, img.Width(), img.Height()), &median);
+}
+
+// Median of the (2rx+1)x(2ry+1) window around each pixel, with the image extended by
+// replicating its border pixels, by selecting from a copy of each window.
+void iMedianSelect(const ImgInt& img, int rx, int ry, ImgInt* out)
+{
+  const int w = img.Width(), h = img.Height();
+  std::vector<int> window((2*rx + 1) * (2*ry + 1));
+  const int rank = static_cast<int>(window.size()) / 2;
+  for (int y=0 ; y<h ; y++)
+  {
+    ImgInt::Iterator q = out->Begin(0, y);
+    for (int x=0 ; x<w ; x++)
+    {
+      int n = 0;
+      for (int j=y-ry ; j<=y+ry ; j++)
+      {
+        ImgInt::ConstIterator p = img.Begin(0, blepo_ex::Clamp(j, 0, h - 1));
+        for (int i=x-rx ; i<=x+rx ; i++)  window[n++] = p[ blepo_ex::Clamp(i, 0, w - 1) ];
+      }
+      std::nth_element(window.begin(), window.begin() + rank, window.end());
+      q[x] = window[rank];
+    }
+  }
+}
+
+};
+// ================< end local functions
+
+// Median filter for gray scale images.  The window extends kernel_width/2 pixels on 
+// either side of the pixel and kernel_height/2 pixels above and below it, and pixels 
+// outside the image are taken from the nearest border pixel.
+void MedianFilter(const ImgGray& img, const int kernel_width, const int kernel_height, ImgGray* out)
+{
+  const int rx = kernel_width / 2, ry = kernel_height / 2;
+  if (rx < 0 || ry < 0)  BLEPO_ERROR("Kernel size must not be negative");
+  if (&img == out)
+  {
+    ImgGray tmp(img);
+    MedianFilter(tmp, kernel_width, kernel_height, out);
+    return;
+  }
+  out->Reset(img.Width(), img.Height());
+  if (img.IsNull())  return;
+
+  if (rx == ry && (rx == 1 || rx == 2))  iMedianNetwork(img, rx, out);
+  else                                    iMedianHistogram(img, rx, ry, 256, out);
+}
+
+// Median filter for integer images.  Same window and borders as for gray scale images.
+// The values are replaced by their ranks among the distinct values of the image; as long 
+// as there are at most 4096 of them the ranks are filtered with histograms, otherwise 
+// each window is copied and its median selected.
+void MedianFilter(const ImgInt& img, const int kernel_width, const int kernel_height, ImgInt* out)
+{
+  const int rx = kernel_width / 2, ry = kernel_height / 2;
+  if (rx < 0 || ry < 0)  BLEPO_ERROR("Kernel size must not be negative");
+  if (&img == out)
+  {
+    ImgInt tmp(img);
+    MedianFilter(tmp, kernel_width, kernel_height, out);
+    return;
+  }
+  out->Reset(img.Width(), img.Height());
+  if (img.IsNull())  return;
+
+  std::vector<int> values;
+  ImgInt ranks;
+  if (!ComputeValueRanks(img, 4096, &values, &ranks))
+  {
+    iMedianSelect(img, rx, ry, out);
+    return;
+  }
+  iMedianHistogram(ranks, rx, ry, static_cast<int>(values.size()), out);
+  for (int y=0 ; y<out->Height() ; y++)
+  {
+    ImgInt::Iterator q = out->Begin(0, y);
+    for (int x=0 ; x<out->Width() ; x++)  q[x] = values[ q[x] ];
+  }
+}
+
+};  // end namespace blepo
@@ -0,0 +1,94 @@
+/* 
+ * Copyright (c) 2005 Clemson University.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "FrameArena.h"
+
+// -------------------- all includes must go before these lines ------------------
+#if defined(DEBUG) && defined(WIN32) && !defined(NO_MFC)
+#include <afxwin.h>
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif
+// -------------------- all code must go after these lines -----------------------
+
+// ================> begin local functions (available only to this translation unit)
+namespace
+{
+using namespace blepo;
+
+BLEPO_THREAD_LOCAL FrameArena* g_default_arena = 0;
+
+};
+// ================< end local functions
+
+namespace blepo
+{
+
+FrameArena::FrameArena(int nbytes)
+  : m_block(0), m_capacity(0), m_used(0), m_requested(0), m_nallocations(0)
+{
+  if (nbytes > 0)
+  {
+    m_capacity = iRoundUp(nbytes);
+    m_block = static_cast<unsigned char*>( AlignedRealloc(0, 0, m_capacity, ALIGNMENT) );
+    if (m_block == 0)  BLEPO_ERROR("Out of memory");
+  }
+}
+
+FrameArena::~FrameArena()
+{
+  if (g_default_arena == this)  g_default_arena = 0;
+  AlignedFree(m_block);
+}
+
+void* FrameArena::Allocate(int nbytes)
+{
+  const int n = iRoundUp(nbytes);
+  m_requested += n;
+  if (nbytes <= 0 || m_used + n > m_capacity)  return 0;
+  void* p = m_block + m_used;
+  m_used += n;
+  m_nallocations++;
+  return p;
+}
+
+void FrameArena::BeginFrame()
+{
+  if (m_requested > m_capacity)
+  {  // the last frame did not fit, so make room for all of it
+    AlignedFree(m_block);
+    m_capacity = m_requested;
+    m_block = static_cast<unsigned char*>( AlignedRealloc(0, 0, m_capacity, ALIGNMENT) );
+    if (m_block == 0)  BLEPO_ERROR("Out of memory");
+  }
+  m_used = m_requested = m_nallocations = 0;
+  ClearHeapAllocationCount();
+}
+
+void FrameArena::SetDefault(FrameArena* arena)
+{
+  g_default_arena = arena;
+}
+
+FrameArena* FrameArena::GetDefault()
+{
+  return g_default_arena;
+}
+
+};  // end namespace blepo
@@ -0,0 +1,102 @@
+/* 
+ * Copyright (c) 2005 Clemson University.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __BLEPO_FRAMEARENA_H__
+#define __BLEPO_FRAMEARENA_H__
+
+#include "Utilities/Reallocator.h"
+
+namespace blepo
+{
+
+/**
+  @class FrameArena
+  A bump-pointer allocator for images that live for at most one frame of a video
+  loop.  Allocate() hands out consecutive aligned blocks of one large buffer, and
+  BeginFrame() takes them all back at once, so temporaries cost no heap traffic.
+  If a frame asks for more memory than the arena holds, the extra requests fall 
+  back to the heap (Allocate() returns NULL), and the next BeginFrame() grows the 
+  buffer to the total that was asked for.  After the first frame or two, a loop 
+  that does the same work every frame therefore allocates nothing from the heap.
+
+  Construct an image against an arena with Image<T>(width, height, arena).  To 
+  have the temporaries inside library functions (Smooth, Gradient, Canny, etc.) 
+  use an arena, make it the default arena of the calling thread:
+
+      FrameArena arena;
+      FrameArena::SetDefault(&arena);
+      for (;;)
+      {
+        arena.BeginFrame();
+        ...process one frame...
+        assert(FrameArena::GetHeapAllocationCount().nallocations == 0);
+      }
+
+  An image that uses an arena must not be used after the arena's next BeginFrame().
+  An arena is not thread-safe, so give each thread its own.
+
+  @author Stan Birchfield (STB)
+*/
+
+class FrameArena
+{
+public:
+  explicit FrameArena(int nbytes = 0);
+  ~FrameArena();
+
+  /// Returns 'nbytes' of memory aligned to Reallocator<T>::ALIGNMENT bytes, 
+  /// or NULL if the arena does not have room for them.
+  void* Allocate(int nbytes);
+
+  /// Reclaims all the memory handed out since the previous call, grows the 
+  /// arena if the previous frame did not fit, and clears the heap allocation
+  /// count of the calling thread.
+  void BeginFrame();
+
+  /// @name Statistics for the current frame
+  //@{
+  int Capacity() const { return m_capacity; }          ///< size of the arena, in bytes
+  int NBytesUsed() const { return m_used; }            ///< bytes handed out by the arena
+  int NBytesRequested() const { return m_requested; }  ///< bytes asked for, including requests that did not fit
+  int NAllocations() const { return m_nallocations; }  ///< number of blocks handed out by the arena
+  /// Number of blocks that Reallocator (and hence Image, Array, Matrix) allocated 
+  /// on the heap from the calling thread since BeginFrame()
+  static const HeapAllocationCount& GetHeapAllocationCount() { return blepo::GetHeapAllocationCount(); }
+  //@}
+
+  /// @name Default arena of the calling thread, used for the temporaries inside 
+  /// library functions.  NULL (the default) means that they use the heap.
+  //@{
+  static void SetDefault(FrameArena* arena);
+  static FrameArena* GetDefault();
+  //@}
+
+private:
+  FrameArena(const FrameArena&);  // not implemented
+  FrameArena& operator=(const FrameArena&);  // not implemented
+
+  enum { ALIGNMENT = Reallocator<unsigned char>::ALIGNMENT };
+  static int iRoundUp(int nbytes) { return (nbytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+  unsigned char* m_block;
+  int m_capacity, m_used, m_requested, m_nallocations;
+};
+
+};  // end namespace blepo
+
+#endif //__BLEPO_FRAMEARENA_H__
@@ -17,8 +17,13 @@
  */
 
 #include "Image.h"
+#include <algorithm>  // std::nth_element
 #include <vector>
 #include "Image/ImageAlgorithms.h"  // ColorHistogramx
+#include "Image/ImageOperations.h"  // Set
+#include "Image/SlidingHistogram.h"
+#include "Utilities/Exception.h"
+#include "Utilities/Math.h"
 
 // -------------------- all includes must go before these lines ------------------
 #if defined(DEBUG) && defined(WIN32) && !defined(NO_MFC)
@@ -91,220 +96,278 @@ void HistogramBinary(const ImgGray& img,int* white, int* black)
 			
 
 
-void ConservativeSmoothing(const ImgGray& img,  const int win_width,const int win_height, ImgGray* out)
+// ================> begin local functions (available only to this file)
+namespace
 {
-	out->Reset(img.Width(), img.Height());  
-	const int img_height=img.Height();
-	const int img_width=img.Width();
-		
-	int x_len,y_len;
-	int min,max;
-	int i,j;
-	for (i=0;i<img_width;i++)
-	{
-		for (j=0;j<img_height;j++)
-		{
-			*(out->Begin(i,j)) = *(img.Begin(i,j));
-			
-		}
-	}
-	
-	
-	for(i=0;i<img_width-1;i++)
-	{
-		for(j=0;j<img_height-1;j++)
-		{
-		min=999;
-		max=0;
-		for(int x=-win_width/2;x<=win_width/2;x++)	
-		{
-			for(int y=-win_height/2;y<=win_height/2;y++)
-				{
-					
-					x_len=i+x;y_len=j+y;
-					if((x_len)<0)
-					{
-						x_len=0;
-					}
-					if((y_len)<0)
-					{
-						y_len=0;
-					}
-					if(x_len>img_width-1)
-					{
-						x_len=img_width-2;
-					}
-					if(y_len>img_height-1)
-					{
-						y_len=img_height-2;
-					}
-					//Find the minimum and the maximum value in the window
-					if(img(x_len,y_len)<min && x_len!=i && y_len!=j)
-					{
-						min=img(x_len,y_len);
-					}
-					if(img(x_len,y_len)>max && x_len!=i && y_len!=j)
-					{
-						max=img(x_len,y_len);
-					}
-
-					
-					}
-				     if(img(i,j)<min)//If the centre pixel is less than minimum in the window,set it to min.
-					 {
-						 *(out->Begin(i,j))=min;
-					 }
-					if(img(i,j)>max)//If the centre pixel is greater than maximum in the window, set it to max.
-					{
-						*(out->Begin(i,j))=max;
-					}
-		}
-		}
-	}
+
+// Bins of the pixels of one channel, for a SlidingHistogram
+template <typename T>
+struct iChannelPixels
+{
+  const unsigned char* first;  // channel of the first pixel
+  int stride;                  // bytes from one row to the next
+  int operator()(int x, int y) const { return first[y*stride + x*sizeof(T)]; }
+};
+
+template <typename T>
+struct iPixels
+{
+  const Image<T>* img;
+  int operator()(int x, int y) const { return (*img)(x, y); }
+};
+
+// Writes the value of the given rank in the window to one channel of the output
+template <typename T>
+struct iRankOfWindow
+{
+  unsigned char* first;  // channel of the first output pixel
+  int stride;            // bytes from one row to the next
+  int rank;
+  void operator()(int x, int y, SlidingHistogram& hist) { first[y*stride + x*sizeof(T)] = static_cast<unsigned char>(hist.Select(rank)); }
+};
+
+// Rank filter of one channel of 'img', for the pixels whose window lies inside the image
+template <typename T>
+void iRankFilterChannel(const Image<T>& img, int channel, int rx, int ry, int rank, Image<T>* out)
+{
+  iChannelPixels<T> pixels = { reinterpret_cast<const unsigned char*>(img.Begin()) + channel, img.Stride() * static_cast<int>(sizeof(T)) };
+  iRankOfWindow<T> visit = { reinterpret_cast<unsigned char*>(out->Begin()) + channel, out->Stride() * static_cast<int>(sizeof(T)), rank };
+  SlidingHistogram hist(256);
+  hist.Slide(pixels, img.Width(), img.Height(), rx, ry, Rect(rx, ry, img.Width() - rx, img.Height() - ry), &visit);
 }
 
-void ConservativeSmoothing(const ImgFloat& img,  const int win_width,const int win_height, ImgFloat* out)
+int iRankIndex(int rx, int ry, int rank)
 {
-	out->Reset(img.Width(), img.Height());  
-	const int img_height=img.Height();
-	const int img_width=img.Width();
-		
-	int x_len,y_len;
-	int min,max;
-	int i,j;
-	for (i=0;i<img_width;i++)
-	{
-		for (j=0;j<img_height;j++)
-		{
-			*(out->Begin(i,j)) = *(img.Begin(i,j));
-			
-		}
-	}
-	
-	
-	for(i=0;i<img_width-1;i++)
-	{
-		for(j=0;j<img_height-1;j++)
-		{
-		min=999;
-		max=0;
-		for(int x=-win_width/2;x<=win_width/2;x++)	
-		{
-			for(int y=-win_height/2;y<=win_height/2;y++)
-				{
-					
-					x_len=i+x;y_len=j+y;
-					if((x_len)<0)
-					{
-						x_len=0;
-					}
-					if((y_len)<0)
-					{
-						y_len=0;
-					}
-					if(x_len>img_width-1)
-					{
-						x_len=img_width-2;
-					}
-					if(y_len>img_height-1)
-					{
-						y_len=img_height-2;
-					}
-					//Find the minimum and the maximum value in the window
-					if(img(x_len,y_len)<min && x_len!=i && y_len!=j)
-					{
-						min=(int)img(x_len,y_len);
-					}
-					if(img(x_len,y_len)>max && x_len!=i && y_len!=j)
-					{
-						max=(int)img(x_len,y_len);
-					}
-
-					
-					}
-				     if(img(i,j)<min)//If the centre pixel is less than minimum in the window,set it to min.
-					 {
-						 *(out->Begin(i,j))=(float)min;
-					 }
-					if(img(i,j)>max)//If the centre pixel is greater than maximum in the window, set it to max.
-					{
-						*(out->Begin(i,j))=(float)max;
-					}
-		}
-		}
-	}
+  const int n = (2*rx + 1) * (2*ry + 1);  // number of pixels in a window
+  return (rank < 1 || rank > n) ? n / 2 : rank - 1;
 }
 
-void ConservativeSmoothing(const ImgInt& img,  const int win_width,const int win_height, ImgInt* out)
+// Conservative smoothing clamps each pixel between the smallest and the largest of the 
+// other pixels in its window.  If the pixel is the smallest of its window, the smallest
+// of the others is the second smallest of the window; otherwise the pixel is at least 
+// the second smallest.  So the pixel is clamped between the values of rank 1 and n-2.
+template <typename T>
+struct iConservative
 {
-	out->Reset(img.Width(), img.Height());  
-	const int img_height=img.Height();
-	const int img_width=img.Width();
-		
-	int x_len,y_len;
-	int min,max;
-	int i,j;
-	for (i=0;i<img_width;i++)
-	{
-		for (j=0;j<img_height;j++)
-		{
-			*(out->Begin(i,j)) = *(img.Begin(i,j));
-			
-		}
-	}
-	
-	
-	for(i=0;i<img_width-1;i++)
-	{
-		for(j=0;j<img_height-1;j++)
-		{
-		min=999;
-		max=0;
-		for(int x=-win_width/2;x<=win_width/2;x++)	
-		{
-			for(int y=-win_height/2;y<=win_height/2;y++)
-				{
-					
-					x_len=i+x;y_len=j+y;
-					if((x_len)<0)
-					{
-						x_len=0;
-					}
-					if((y_len)<0)
-					{
-						y_len=0;
-					}
-					if(x_len>img_width-1)
-					{
-						x_len=img_width-2;
-					}
-					if(y_len>img_height-1)
-					{
-						y_len=img_height-2;
-					}
-					//Find the minimum and the maximum valu in the window
-					if(img(x_len,y_len)<min && x_len!=i && y_len!=j)
-					{
-						min=img(x_len,y_len);
-					}
-					if(img(x_len,y_len)>max && x_len!=i && y_len!=j)
-					{
-						max=img(x_len,y_len);
-					}
-
-					
-					}
-				     if(img(i,j)<min)//If the centre pixel is less than minimum in the window,set it to min.
-					 {
-						 *(out->Begin(i,j))=min;
-					 }
-					if(img(i,j)>max)//If the centre pixel is greater than maximum in the window, set it to max.
-					{
-						*(out->Begin(i,j))=max;
-					}
-		}
-		}
-	}
+  typename Image<T>::ConstIterator in;  // first pixel of the input
+  typename Image<T>::Iterator out;      // first pixel of the output
+  int in_stride, out_stride;
+  int n;  // number of pixels in a window
+  const T* values;  // value of each bin, or NULL if the bins are the values
+  T Value(int bin) const { return values ? values[bin] : static_cast<T>(bin); }
+  void operator()(int x, int y, SlidingHistogram& hist) 
+  { 
+    T v = in[y*in_stride + x];
+    if (n >= 3)  v = blepo_ex::Clamp(v, Value(hist.Select(1)), Value(hist.Select(n - 2)));
+    out[y*out_stride + x] = v;
+  }
+};
+
+// graylevel histogram of 'img', for the Otsu thresholds
+void iHistogram256(const ImgGray& img, vector<int>* hist)
+{
+  hist->assign(256, 0);
+  for (int y=0 ; y<img.Height() ; y++)
+  {
+    ImgGray::ConstIterator p = img.Begin(0, y);
+    for (int x=0 ; x<img.Width() ; x++)  (*hist)[ p[x] ]++;
+  }
+}
+
+// Contribution n mu^2 of the class of bins [a,b) to Otsu's criterion, from the cumulative
+// counts 'n' and sums 's' of the histogram
+inline double iOtsuClassScore(const vector<double>& n, const vector<double>& s, int a, int b)
+{
+  const double count = n[b] - n[a], sum = s[b] - s[a];
+  return (count > 0) ? sum * sum / count : 0;
+}
+
+};
+// ================< end local functions
+
+void RankFilter(const ImgBgr& img, int rx, int ry, ImgBgr* out, int rank)
+{
+  assert(rx >= 0 && ry >= 0);
+  assert(&img != out);
+  out->Reset(img.Width(), img.Height());
+  Set(out, Bgr(0, 0, 0));
+  const int r = iRankIndex(rx, ry, rank);
+  for (int channel=0 ; channel<3 ; channel++)  iRankFilterChannel(img, channel, rx, ry, r, out);
+}
+
+void RankFilter(const ImgGray& img, int rx, int ry, ImgGray* out, int rank)
+{
+  assert(rx >= 0 && ry >= 0);
+  assert(&img != out);
+  out->Reset(img.Width(), img.Height());
+  Set(out, 0);
+  iRankFilterChannel(img, 0, rx, ry, iRankIndex(rx, ry, rank), out);
+}
+
+// The window extends win_width/2 pixels on either side of the pixel and win_height/2 
+// pixels above and below it; pixels outside the image are taken from the nearest border 
+// pixel.  Integer and floating point images with more than 4096 distinct values are 
+// filtered by scanning each window.
+void ConservativeSmoothing(const ImgGray& img, const int win_width, const int win_height, ImgGray* out)
+{
+  const int rx = win_width / 2, ry = win_height / 2;
+  assert(rx >= 0 && ry >= 0);
+  if (&img == out)
+  {
+    ImgGray tmp(img);
+    ConservativeSmoothing(tmp, win_width, win_height, out);
+    return;
+  }
+  out->Reset(img.Width(), img.Height());
+  iPixels<unsigned char> pixels = { &img };
+  iConservative<unsigned char> visit = { img.Begin(), out->Begin(), img.Stride(), out->Stride(), (2*rx + 1) * (2*ry + 1), NULL };
+  SlidingHistogram hist(256);
+  hist.Slide(pixels, img.Width(), img.Height(), rx, ry, Rect(0, 0, img.Width(), img.Height()), &visit);
+}
+
+template <typename T>
+void iConservativeSmoothing(const Image<T>& img, int rx, int ry, Image<T>* out)
+{
+  assert(rx >= 0 && ry >= 0);
+  const int w = img.Width(), h = img.Height(), n = (2*rx + 1) * (2*ry + 1);
+  if (&img == out)
+  {
+    Image<T> tmp(img);
+    iConservativeSmoothing(tmp, rx, ry, out);
+    return;
+  }
+  out->Reset(w, h);
+
+  std::vector<T> values;
+  ImgInt ranks;
+  if (ComputeValueRanks(img, 4096, &values, &ranks))
+  {
+    iPixels<int> pixels = { &ranks };
+    iConservative<T> visit = { img.Begin(), out->Begin(), img.Stride(), out->Stride(), n, &values[0] };
+    SlidingHistogram hist(static_cast<int>(values.size()));
+    hist.Slide(pixels, w, h, rx, ry, Rect(0, 0, w, h), &visit);
+    return;
+  }
+
+  std::vector<T> window(n);
+  for (int y=0 ; y<h ; y++)
+  {
+    typename Image<T>::Iterator q = out->Begin(0, y);
+    for (int x=0 ; x<w ; x++)
+    {
+      int k = 0;
+      for (int j=y-ry ; j<=y+ry ; j++)
+      {
+        typename Image<T>::ConstIterator p = img.Begin(0, blepo_ex::Clamp(j, 0, h - 1));
+        for (int i=x-rx ; i<=x+rx ; i++)  window[k++] = p[ blepo_ex::Clamp(i, 0, w - 1) ];
+      }
+      T v = img(x, y);
+      if (n >= 3)
+      {
+        std::nth_element(window.begin(), window.begin() + 1, window.end());
+        const T lo = window[1];
+        std::nth_element(window.begin(), window.begin() + n - 2, window.end());
+        v = blepo_ex::Clamp(v, lo, window[n - 2]);
+      }
+      q[x] = v;
+    }
+  }
+}
+
+void ConservativeSmoothing(const ImgFloat& img, const int win_width, const int win_height, ImgFloat* out)
+{
+  iConservativeSmoothing(img, win_width / 2, win_height / 2, out);
+}
+
+void ConservativeSmoothing(const ImgInt& img, const int win_width, const int win_height, ImgInt* out)
+{
+  iConservativeSmoothing(img, win_width / 2, win_height / 2, out);
+}
+
+// Otsu's method chooses the threshold that maximizes the between-class variance 
+// n0 n1 (mu0 - mu1)^2 of the two classes of bins, in one pass over the histogram.
+int OtsuThreshold(const vector<int>& hist)
+{
+  const int nbins = hist.size();
+  if (nbins < 2)  BLEPO_ERROR("Histogram must have at least two bins");
+  double n = 0, sum = 0;
+  int i;
+  for (i=0 ; i<nbins ; i++)
+  {
+    n += hist[i];
+    sum += (double) i * hist[i];
+  }
+
+  double n0 = 0, sum0 = 0, best = -1;
+  int th = 1;
+  for (i=1 ; i<nbins ; i++)
+  {
+    n0 += hist[i-1];
+    sum0 += (double) (i-1) * hist[i-1];
+    const double n1 = n - n0;
+    if (n0 == 0 || n1 == 0)  continue;
+    const double d = sum0 / n0 - (sum - sum0) / n1;
+    const double var = n0 * n1 * d * d;
+    if (var > best)  { best = var;  th = i; }
+  }
+  return th;
+}
+
+// With more than two classes, maximizing the between-class variance is the same as 
+// maximizing the sum of n_k mu_k^2 over the classes, which is found exactly by dynamic 
+// programming over the first bin of the last class:  O(nthresholds * nbins^2).
+void OtsuThresholds(const vector<int>& hist, int nthresholds, vector<int>* thresholds)
+{
+  const int nbins = hist.size(), nclasses = nthresholds + 1;
+  if (nthresholds < 1 || nbins < nclasses)  BLEPO_ERROR("Histogram must have more bins than thresholds");
+  int a, b, k;
+
+  // cumulative counts and sums:  bins [a,b) hold n[b]-n[a] pixels
+  vector<double> n(nbins + 1, 0), s(nbins + 1, 0);
+  for (b=0 ; b<nbins ; b++)
+  {
+    n[b+1] = n[b] + hist[b];
+    s[b+1] = s[b] + (double) b * hist[b];
+  }
+
+  // score[k*(nbins+1) + b]:  best criterion for k+1 classes covering bins [0,b)
+  // first[k*(nbins+1) + b]:  first bin of the last of those classes
+  vector<double> score(nclasses * (nbins + 1), -1);
+  vector<int> first(nclasses * (nbins + 1), 0);
+  for (b=1 ; b<=nbins ; b++)  score[b] = iOtsuClassScore(n, s, 0, b);
+  for (k=1 ; k<nclasses ; k++)
+  {
+    for (b=k+1 ; b<=nbins ; b++)
+    {
+      double& best = score[k*(nbins+1) + b];
+      for (a=k ; a<b ; a++)
+      {
+        const double v = score[(k-1)*(nbins+1) + a] + iOtsuClassScore(n, s, a, b);
+        if (v > best)  { best = v;  first[k*(nbins+1) + b] = a; }
+      }
+    }
+  }
+
+  thresholds->resize(nthresholds);
+  for (k=nclasses-1, b=nbins ; k>0 ; k--)
+  {
+    b = first[k*(nbins+1) + b];
+    (*thresholds)[k-1] = b;
+  }
+}
+
+int ComputeOtsuThreshold(const ImgGray& img)
+{
+  vector<int> hist;
+  iHistogram256(img, &hist);
+  return OtsuThreshold(hist);
+}
+
+void ComputeOtsuThresholds(const ImgGray& img, int nthresholds, vector<int>* thresholds)
+{
+  vector<int> hist;
+  iHistogram256(img, &hist);
+  OtsuThresholds(hist, nthresholds, thresholds);
 }
 
 // should make these member variables of ColorHistogramx class
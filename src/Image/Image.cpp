@@ -1,76 +1,224 @@
-/* 
- * Copyright (c) 2004, 2005 Clemson University.
- *
- * This program is free software; you can redistribute it and/or modify
- * it under the terms of the GNU General Public License as published by
- * the Free Software Foundation; either version 2 of the License, or (at
- * your option) any later version.
- * 
- * This program is distributed in the hope that it will be useful, but
- * WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
- * General Public License for more details.
- * 
- * You should have received a copy of the GNU General Public License
- * along with this program; if not, write to the Free Software
- * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
- */
-
-#include "Image.h"
-#include <limits.h>  // INT_MIN, INT_MAX
-#include <float.h>  // FLT_MAX
-
-// -------------------- all includes must go before these lines ------------------
-#if defined(DEBUG) && defined(WIN32) && !defined(NO_MFC)
-#include <afxwin.h>
-#define new DEBUG_NEW
-#undef THIS_FILE
-static char THIS_FILE[] = __FILE__;
-#endif
-// -------------------- all code must go after these lines -----------------------
-
-
-namespace blepo
-{
-
-// ImgBgr
-const int ImgBgr::NBITS_PER_PIXEL = 24;
-const int ImgBgr::NCHANNELS = 3;
-const ImgBgr::Pixel ImgBgr::MIN_VAL = Bgr(0,0,0);
-const ImgBgr::Pixel ImgBgr::MAX_VAL = Bgr(0xFF, 0xFF, 0xFF);
-
-// ImgFloat
-const int ImgFloat::NBITS_PER_PIXEL = 32;
-const int ImgFloat::NCHANNELS = 1;
-const ImgFloat::Pixel ImgFloat::MIN_VAL = -FLT_MAX;
-const ImgFloat::Pixel ImgFloat::MAX_VAL =  FLT_MAX;  // = 3.402823466e+38F
-
-// ImgGray
-const int ImgGray::NBITS_PER_PIXEL = 8;
-const int ImgGray::NCHANNELS = 1;
-const ImgGray::Pixel ImgGray::MIN_VAL = 0;
-const ImgGray::Pixel ImgGray::MAX_VAL = 255;
-
-// ImgInt
-const int ImgInt::NBITS_PER_PIXEL = 32;
-const int ImgInt::NCHANNELS = 1;
-const ImgInt::Pixel ImgInt::MIN_VAL = INT_MIN;  // = -2147483648
-const ImgInt::Pixel ImgInt::MAX_VAL = INT_MAX;  // =  2147483647
-
-// ImgBinary
-const int ImgBinary::NBITS_PER_PIXEL = 1;
-const int ImgBinary::NCHANNELS = 1;
-const ImgBinary::Pixel ImgBinary::MIN_VAL = 0;
-const ImgBinary::Pixel ImgBinary::MAX_VAL = 1;
-
-Bgr Bgr::BLUE    (255,   0,   0);
-Bgr Bgr::GREEN   (  0, 255,   0);
-Bgr Bgr::RED     (  0,   0, 255);
-Bgr Bgr::YELLOW  (  0, 255, 255);
-Bgr Bgr::CYAN    (255, 255,   0);
-Bgr Bgr::MAGENTA (255,   0, 255);
-Bgr Bgr::WHITE   (255, 255, 255);
-Bgr Bgr::BLACK   (  0,   0,   0);
-
-};  // end namespace blepo
-
+/* 
+ * Copyright (c) 2004, 2005 Clemson University.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Image.h"
+#include <limits.h>  // INT_MIN, INT_MAX
+#include <float.h>  // FLT_MAX, DBL_MAX
+#include <string.h>  // memcpy(), memcmp()
+#ifdef WIN32
+#ifdef NO_MFC
+#include <windows.h>  // CreateFileMapping(), MapViewOfFile()
+#else
+#include <afxwin.h>  // CreateFileMapping(), MapViewOfFile()
+#endif
+#else
+#include <fcntl.h>  // open()
+#include <unistd.h>  // close(), ftruncate()
+#include <sys/mman.h>  // mmap(), munmap(), msync()
+#include <sys/stat.h>  // fstat()
+#endif
+
+// -------------------- all includes must go before these lines ------------------
+#if defined(DEBUG) && defined(WIN32) && !defined(NO_MFC)
+#include <afxwin.h>
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif
+// -------------------- all code must go after these lines -----------------------
+
+
+namespace blepo
+{
+
+// ImgBgr
+const int ImgBgr::NBITS_PER_PIXEL = 24;
+const int ImgBgr::NCHANNELS = 3;
+const ImgBgr::Pixel ImgBgr::MIN_VAL = Bgr(0,0,0);
+const ImgBgr::Pixel ImgBgr::MAX_VAL = Bgr(0xFF, 0xFF, 0xFF);
+
+// ImgFloat
+const int ImgFloat::NBITS_PER_PIXEL = 32;
+const int ImgFloat::NCHANNELS = 1;
+const ImgFloat::Pixel ImgFloat::MIN_VAL = -FLT_MAX;
+const ImgFloat::Pixel ImgFloat::MAX_VAL =  FLT_MAX;  // = 3.402823466e+38F
+
+// ImgGray
+const int ImgGray::NBITS_PER_PIXEL = 8;
+const int ImgGray::NCHANNELS = 1;
+const ImgGray::Pixel ImgGray::MIN_VAL = 0;
+const ImgGray::Pixel ImgGray::MAX_VAL = 255;
+
+// ImgInt
+const int ImgInt::NBITS_PER_PIXEL = 32;
+const int ImgInt::NCHANNELS = 1;
+const ImgInt::Pixel ImgInt::MIN_VAL = INT_MIN;  // = -2147483648
+const ImgInt::Pixel ImgInt::MAX_VAL = INT_MAX;  // =  2147483647
+
+// ImgUShort
+const int ImgUShort::NBITS_PER_PIXEL = 16;
+const int ImgUShort::NCHANNELS = 1;
+const ImgUShort::Pixel ImgUShort::MIN_VAL = 0;
+const ImgUShort::Pixel ImgUShort::MAX_VAL = 65535;
+
+// ImgBinary
+const int ImgBinary::NBITS_PER_PIXEL = 1;
+const int ImgBinary::NCHANNELS = 1;
+const ImgBinary::Pixel ImgBinary::MIN_VAL = 0;
+const ImgBinary::Pixel ImgBinary::MAX_VAL = 1;
+
+// ImgDouble
+const int ImgDouble::NBITS_PER_PIXEL = 64;
+const int ImgDouble::NCHANNELS = 1;
+const ImgDouble::Pixel ImgDouble::MIN_VAL = -DBL_MAX;
+const ImgDouble::Pixel ImgDouble::MAX_VAL =  DBL_MAX;
+
+Bgr Bgr::BLUE    (255,   0,   0);
+Bgr Bgr::GREEN   (  0, 255,   0);
+Bgr Bgr::RED     (  0,   0, 255);
+Bgr Bgr::YELLOW  (  0, 255, 255);
+Bgr Bgr::CYAN    (255, 255,   0);
+Bgr Bgr::MAGENTA (255,   0, 255);
+Bgr Bgr::WHITE   (255, 255, 255);
+Bgr Bgr::BLACK   (  0,   0,   0);
+
+// ================> begin local functions (available only to this translation unit)
+namespace
+{
+
+// Header at the beginning of a mapped image file, padded to ImageFileMapping::HEADER_SIZE bytes
+struct iMappedImageHeader
+{
+  char magic[8];
+  int width, height;
+  int pixel_size;  // bytes per pixel
+  int pixel_type;  // MappedPixelType<T>::TAG
+};
+
+const char iMAPPED_IMAGE_MAGIC[8] = { 'B', 'L', 'E', 'P', 'O', 'I', 'M', 'G' };
+
+};
+// ================> end local functions (available only to this translation unit)
+
+void ImageFileMapping::Create(const char* filename, int width, int height, int pixel_size, int pixel_type)
+{
+  assert(width >= 0 && height >= 0 && pixel_size > 0);
+  iMap(filename, HEADER_SIZE + size_t(width) * height * pixel_size, true, true);
+  iMappedImageHeader* hdr = static_cast<iMappedImageHeader*>(m_view);
+  memset(m_view, 0, HEADER_SIZE);
+  memcpy(hdr->magic, iMAPPED_IMAGE_MAGIC, sizeof(hdr->magic));
+  hdr->width = width;
+  hdr->height = height;
+  hdr->pixel_size = pixel_size;
+  hdr->pixel_type = pixel_type;
+}
+
+void ImageFileMapping::Open(const char* filename, int pixel_size, int pixel_type, bool writable, int* width, int* height)
+{
+  iMap(filename, 0, false, writable);
+  const iMappedImageHeader* hdr = static_cast<const iMappedImageHeader*>(m_view);
+  if (m_nbytes < HEADER_SIZE || memcmp(hdr->magic, iMAPPED_IMAGE_MAGIC, sizeof(hdr->magic)) != 0)
+  {
+    Close();
+    BLEPO_ERROR(StringEx("'%s' is not a mapped image file", filename));
+  }
+  if (hdr->pixel_size != pixel_size || hdr->pixel_type != pixel_type || hdr->width < 0 || hdr->height < 0
+      || m_nbytes < HEADER_SIZE + size_t(hdr->width) * hdr->height * pixel_size)
+  {
+    Close();
+    BLEPO_ERROR(StringEx("Mapped image file '%s' does not match the image type", filename));
+  }
+  *width = hdr->width;
+  *height = hdr->height;
+}
+
+// Maps the whole file, first setting its size to 'nbytes' if 'create' is true
+void ImageFileMapping::iMap(const char* filename, size_t nbytes, bool create, bool writable)
+{
+  Close();
+#ifdef WIN32
+  HANDLE file = CreateFileA(filename, GENERIC_READ | (writable ? GENERIC_WRITE : 0), FILE_SHARE_READ | FILE_SHARE_WRITE, 
+                            NULL, create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)  BLEPO_ERROR(StringEx("Unable to open file '%s'", filename));
+  if (!create)
+  {
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    nbytes = static_cast<size_t>(size.QuadPart);
+  }
+  const unsigned __int64 n = nbytes;
+  HANDLE map = CreateFileMappingA(file, NULL, writable ? PAGE_READWRITE : PAGE_WRITECOPY, 
+                                  static_cast<DWORD>(n >> 32), static_cast<DWORD>(n), NULL);
+  void* view = map ? MapViewOfFile(map, writable ? FILE_MAP_WRITE : FILE_MAP_COPY, 0, 0, nbytes) : NULL;
+  if (view == NULL)
+  {
+    if (map)  CloseHandle(map);
+    CloseHandle(file);
+    BLEPO_ERROR(StringEx("Unable to map file '%s'", filename));
+  }
+  m_file = file;
+  m_map = map;
+#else
+  int fd = open(filename, create ? (O_RDWR | O_CREAT | O_TRUNC) : (writable ? O_RDWR : O_RDONLY), 0644);
+  if (fd < 0)  BLEPO_ERROR(StringEx("Unable to open file '%s'", filename));
+  if (create)
+  {
+    if (ftruncate(fd, nbytes) != 0)  { close(fd);  BLEPO_ERROR(StringEx("Unable to resize file '%s'", filename)); }
+  }
+  else
+  {
+    struct stat st;
+    fstat(fd, &st);
+    nbytes = static_cast<size_t>(st.st_size);
+  }
+  // a private mapping of a read-only file is writable, but the changes stay in memory
+  void* view = mmap(0, nbytes, PROT_READ | PROT_WRITE, writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+  close(fd);  // the mapping keeps the file open
+  if (view == MAP_FAILED)  BLEPO_ERROR(StringEx("Unable to map file '%s'", filename));
+#endif
+  m_view = view;
+  m_nbytes = nbytes;
+}
+
+void ImageFileMapping::Close()
+{
+  if (m_view == 0)  return;
+#ifdef WIN32
+  UnmapViewOfFile(m_view);
+  CloseHandle(static_cast<HANDLE>(m_map));
+  CloseHandle(static_cast<HANDLE>(m_file));
+#else
+  munmap(m_view, m_nbytes);
+#endif
+  m_view = m_file = m_map = 0;
+  m_nbytes = 0;
+}
+
+void ImageFileMapping::Flush()
+{
+  if (m_view == 0)  return;
+#ifdef WIN32
+  FlushViewOfFile(m_view, m_nbytes);
+  FlushFileBuffers(static_cast<HANDLE>(m_file));
+#else
+  msync(m_view, m_nbytes, MS_SYNC);
+#endif
+}
+
+};  // end namespace blepo
+
@@ -1,628 +1,1075 @@
-/* 
- * Copyright (c) 2004, 2005, 2006, 2007 Clemson University.
- *
- * This program is free software; you can redistribute it and/or modify
- * it under the terms of the GNU General Public License as published by
- * the Free Software Foundation; either version 2 of the License, or (at
- * your option) any later version.
- * 
- * This program is distributed in the hope that it will be useful, but
- * WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
- * General Public License for more details.
- * 
- * You should have received a copy of the GNU General Public License
- * along with this program; if not, write to the Free Software
- * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
- */
-
-#ifndef __BLEPO_IMAGE_H__
-#define __BLEPO_IMAGE_H__
-
-#include "assert.h"
-#include "Utilities/Reallocator.h"
-#include "Utilities/PointSizeRect.h"
-
-namespace blepo
-{
-
-/**
-  @class Image
-
-  Templated base class for an image.  Pixel data are stored contiguously in row-major
-  format.
-
-    This base class should work for most image types, such as:
-    Image<unsigned char>    8-bit gray-level images
-    Image<struct { unsigned b,g,r }>    24-bit BGR images
-    Image<float>    single-precision floating-point images
-    Image<int>    gray-level images with sizeof(int) bytes per pixel
-    etc.
-    (But note:  The constructor is not called on the pixels, so do not use a 
-     class as the templated type if intialization of the class is required.)
-
-  Packed binary images (one bit per pixel) require specialization because
-  sizeof(bool)==1, i.e., a bool occupies a byte of memory even though it stores 
-  only a bit.
-
-  @author Stan Birchfield (STB)
-*/
-
-template <typename T>
-class Image
-{
-public:
-  /// @name Typedefs
-  //@{
-  typedef T Pixel;
-  typedef T& PixelRef;
-  typedef T* Iterator;
-  typedef const T* ConstIterator;
-  //@}
-
-  /// @name Constants
-  //@{
-	static const int NBITS_PER_PIXEL;   ///< number of bits per pixel
-	static const int NCHANNELS;        ///< number of channels
-	static const Pixel MIN_VAL;     ///< minimum pixel value 
-	static const Pixel MAX_VAL;     ///< maximum pixel value 
-  //@}
-
-public:
-  /// Constructor / destructor / copy constructor
-  //@{
-  explicit Image()                       : m_width(0), m_height(0), m_data() {}
-  explicit Image(int width, int height)  : m_width(0), m_height(0), m_data() { Reset(width, height); }
-  Image(const Image& other)   : m_width(0), m_height(0), m_data() { *this = other; } 
-  ~Image() {}
-  //@}
-
-  /// Assignment operator
-  Image& operator=(const Image& other) 
-  { 
-    m_width = other.m_width;
-    m_height = other.m_height;
-    m_data = other.m_data;
-    return *this;
-  }
-
-  /// @name Reinitialization
-  /// After calling Reset(), the image will be in the exact same state as if you 
-  /// were to instantiate a new object by calling the constructor with those same parameters.
-  /// Notice that the parameters for Reset() are identical to those for the constructor.
-  //@{
-  void Reset(int width, int height)
-  {
-    m_width = width;
-    m_height = height;
-    m_data.Reset(width*height);
-  }
-  void Reset() { Reset(0,0); }
-  //@}
-
-  /// Changes the dimensions of the image without changing the elements.
-  /// The number of elements (i.e., width*height) must be the same; 
-  ///     otherwise this function has no effect.
-  /// Returns true upon success, false otherwise
-  bool Reshape(int width, int height)
-  {
-    if (m_width * m_height == width * height)
-    {
-      m_width = width;
-      m_height = height;
-      return true;
-    }
-    else
-    {
-      return false;
-    }
-  }
-
-public:
-  /// @name Image info
-  //@{
-  int Width()  const { return m_width;  }  ///< Number of pixels in a row
-  int Height() const { return m_height; }  ///< Number of pixels in a column
-  int NBytes() const { return m_width*m_height*sizeof(T); }  ///< Total number of bytes in the image
-  int IsNull() const { return m_width==0 || m_height==0; }  ///< Whether image contains any pixels
-  //@}
-
-  /// @name Pixel accessing functions (inefficient but convenient)
-  //@{
-  const Pixel& operator()(int x, int y) const   { return *(Begin(x, y)); }
-  Pixel& operator()(int x, int y)               { return *(Begin(x, y)); }
-  const Pixel& operator()(int index) const      { return *(Begin(index)); }
-  Pixel& operator()(int index)                  { return *(Begin(index)); }
-  //@}
-
-  /// @name Iterator functions for fast pixel accessing
-  //@{
-  ConstIterator Begin() const             { return m_data.Begin(); }
-  ConstIterator Begin(int x, int y) const { assert(x>=0 && x<m_width && y>=0 && y<m_height);  return m_data.Begin()+y*m_width+x; }
-  ConstIterator Begin(int index) const    { assert(index>=0 && index<m_width*m_height);  return m_data.Begin()+index; }
-  ConstIterator End() const               { return m_data.End(); }
-  Iterator Begin()                        { return m_data.Begin(); }
-  Iterator Begin(int x, int y)            { assert(x>=0 && x<m_width && y>=0 && y<m_height);  return m_data.Begin()+y*m_width+x; }
-  Iterator Begin(int index)               { assert(index>=0 && index<m_width*m_height);  return m_data.Begin()+index; }
-  Iterator End()                          { return m_data.End(); }
-  //@}
-
-  /// Get pointer to raw data, as unsigned char*
-  //@{
-  const unsigned char* BytePtr()    const { return reinterpret_cast<const unsigned char*>(m_data.Begin()); }
-  unsigned char*       BytePtr()          { return reinterpret_cast<unsigned char*>      (m_data.Begin()); }
-  const unsigned char* BytePtrEnd() const { return reinterpret_cast<const unsigned char*>(m_data.End());   }
-  unsigned char*       BytePtrEnd()       { return reinterpret_cast<unsigned char*>      (m_data.End());   }
-  //@}
-
-  /// RectIterator for iterating through a rectangle of an image
-  /// Example:
-  ///    ImgBgr::RectIterator p = img.BeginRect();
-  ///    while (!p.AtEnd())  *p++;
-  /// Implementation note:  Be sure not to provide an automatic conversion to 
-  /// an Iterator from this class, or someone might accidentally compare with
-  /// the end of the image, as in
-  ///    while (p != img.End())  *p++
-  /// which would yield the wrong behavior with no compile-time warning or error.
-  /// Currently, a compile-time error prevents users from inadvertently making
-  /// this mistake.
-  class RectIterator
-  {
-  public:
-    RectIterator(Image<T>& img, const Rect& rect)
-    {
-      m_p = img.Begin(rect.left, rect.top);
-      m_p_row = m_p + rect.Width();
-      m_p_end = img.Begin(rect.left, rect.bottom-1) + img.Width();
-      m_skip = img.Width() - rect.Width();
-      m_img_width = img.Width();
-    }
-    Pixel& operator*() const { return *m_p; }
-    /// prefix increment (++p)
-    RectIterator& operator++()    
-    { 
-      m_p++;
-      if (m_p == m_p_row)  { m_p += m_skip;  m_p_row += m_img_width; }
-      return *this; 
-    }
-    /// postfix increment (p++)
-    RectIterator  operator++(int) { RectIterator tmp=*this;  ++(*this);  return tmp; }  
-    bool AtEnd() const { return m_p == m_p_end; }
-  private:
-    Iterator m_p, m_p_row, m_p_end;
-    int m_skip, m_img_width;
-  };
-
-  class ConstRectIterator
-  {
-  public:
-    ConstRectIterator(const Image<T>& img, const Rect& rect)
-    {
-      m_p = img.Begin(rect.left, rect.top);
-      m_p_row = m_p + rect.Width();
-      m_p_end = img.Begin(rect.left, rect.bottom-1) + img.Width();
-      m_skip = img.Width() - rect.Width();
-      m_img_width = img.Width();
-    }
-    const Pixel& operator*() const { return *m_p; }
-    /// prefix increment (++p)
-    ConstRectIterator& operator++()    
-    { 
-      m_p++;
-      if (m_p == m_p_row)  { m_p += m_skip;  m_p_row += m_img_width; }
-      return *this; 
-    }
-    /// postfix increment (p++)
-    ConstRectIterator  operator++(int) { ConstRectIterator tmp=*this;  ++(*this);  return tmp; }  
-    bool AtEnd() const { return m_p == m_p_end; }
-  private:
-    ConstIterator m_p, m_p_row, m_p_end;
-    int m_skip, m_img_width;
-  };
-
-  RectIterator BeginRect(const Rect& rect) { return RectIterator(*this, rect); }
-  ConstRectIterator BeginRect(const Rect& rect) const { return ConstRectIterator(*this, rect); }
-
-private:
-  int m_width, m_height;  ///< image dimensions
-  Reallocator<T> m_data;  //< image data
-};
-
-
-/**
-  @class Image<bool>
-  Specialization for a packed binary image, with one bit per pixel.  The first pixel 
-  is stored in the most significant bit of the first byte, the second pixel in the 
-  next bit, and so on.  If Width()*Height() is not divisible by 8, then the final 
-  byte will contain some unused bits (in its least significant bits).  
-
-  The interface of this class is exactly the same as the other image classes.  The
-  only exception is that sizeof(Image<bool>::Pixel) returns sizeof(bool)=1 byte, 
-  which is incorrect because only one bit per pixel is actually used.  It is this
-  inconsistency in the native bool datatype that causes the code to be so complicated.
-  Keep in mind that the packed bytes can be accessed directly using the BytePtr() 
-  functions.
-  
-  Allow me to say a word about the ordering of the pixels in the packed bytes.  The 
-  ordering described above seems to be the most natural representation because 
-     (1) pixels with smaller coordinates are stored in lower memory addresses,
-         i.e., the first byte of the allocated block of memory contains the first
-         eight pixels of the image; and
-     (2) a bit shift right causes pixels to be shifted to the right.
-
-  Unfortunately, this choice has a drawback.  Intel processors use the little-endian 
-  format, which means that when a word of memory is loaded into a register, the byte at
-  the low memory address is stored in the low byte of the word.  For example, suppose
-  the first two bytes of our image look like this:
-       A7-A6-A5-A4-A3-A2-A1-A0-B7-B6-B5-B4-B3-B2-B1-B0,
-  where A0 is the least significant bit of the first byte, and B0 the least 
-  significant bit of the second byte.  Loading the word (i.e., the 16 bits containing 
-  A and B) into a register yields the following contents for the register:
-       B7-B6-B5-B4-B3-B2-B1-B0-A7-A6-A5-A4-A3-A2-A1-A0
-  because byte A is stored at the lower memory address.  The problem here is that B0 
-  and A7 are now adjacent in the register, even though they are not adjacent in the 
-  image.  As a result, a bit shift in the register will cause artifacts at the byte 
-  boundary.  The same problem occurs at all the byte boundaries after loading 
-  a double-word (32 bits), quad-word (64 bits), or double-quad-word (128 bits).
-    
-  The only way to fix this problem is to discard one of the two goals above.  For
-  example, we could store the image backward, with the last eight pixels of the image 
-  in the first allocated block.  Incrementing the pointer would cause the image to be
-  traversed from right to left and from bottom to top.  This seems unnatural.  
-  Alternatively, we could store the first pixel in the least significant bit of the 
-  first pixel, the second pixel in the bit to its left, and so forth.  One appealing
-  property of this approach is that (in our example above) A0 contains img(0,0), while
-  A1 contains img(1,0), i.e., the indices of the image and the bit line up.  On the
-  other hand, a terrible consequence is that a bit shift right would actually cause
-  the image pixels to shift left, which seems very unnatural indeed.  Although either
-  of these choices could be implemented easily without significantly affecting the
-  user (who would be largely insulated from the underlying representation via the 
-  Iterator class), it is not clear which is the best choice.  
-
-  For clarity, let us define the four choices according to whether traversing the image
-  pixels from the top left to the bottom right either
-     - increases or decreases the bit number (0 to 7)
-     - increases or decreases the byte number (memory address)
-  The four choices are
-    (1) increasing bits, increasing bytes (IBIB)
-        Good:  works for Little Endian machines
-        Bad:   bit shift left actually shifts pixels right
-    (2) increasing bits, decreasing bytes (IBDB)
-        Good:  works for Little Endian machines
-        Bad:   first byte is at end of allocated block
-    (3) decreasing bits, increasing bytes (DBIB)
-        Good:  natural choice
-        Bad:   works for Big Endian machines
-    (4) decreasing bits, decreasing bytes (DBDB)
-        Bad:   first byte is at end of allocated block
-        Bad:   works for Big Endian machines
-        (I.e., DBDB is not a viable option b/c it is altogether bad)
-
-  Examples of the four choices are shown below.  A and B are two 
-  consecutive bytes, and the ellipsis (...) indicates the rest of
-  the pixels in the image.  The values in the four rows above A and
-  B are the indices of the first 16 pixels in the image.
-
-     DBDB: ... 08 09 10 11 12 13 14 15 00 01 02 03 04 05 06 07    
-     IBDB: ... 15 14 13 12 11 10 09 08 07 06 05 04 03 02 01 00    
-     IBIB:     07 06 05 04 03 02 01 00 15 14 13 12 11 10 09 08 ...
-     DBIB:     00 01 02 03 04 05 06 07 08 09 10 11 12 13 14 15 ...
-               A7-A6-A5-A4-A3-A2-A1-A0-B7-B6-B5-B4-B3-B2-B1-B0
-        
-  Note that this is an unsolved problem, because it really becomes an
-  issue only when one wishes to perform bit shifting for the entire image.  
-  In Intel's IPP Library, bit shifting does not extend past byte boundaries,
-  so these issues are not addressed.
-
-  @author Stan Birchfield (STB)
-*/
-
-template <>
-class Image<bool>
-{
-public:
-  typedef bool Pixel;
-
-  /// @name Helper classes, because the bool datatype is not packed.
-  //@{
-  class PixelRef;
-  class ConstIterator;
-
-  /// An iterator pointing to a binary pixel, allowing getting and setting of
-  /// values, as well as incrementing and decrementing the iterator.
-  class Iterator 
-  {
-  public:
-    /// You should generally let Image<bool>::Begin() call this constructor
-    /// rather than calling it directly.
-    /// @param index The zero-based one-dimensional index of the pixel to which
-    ///              this iterator points, by treating image as a 1D array using
-    ///              row-major order (i.e., 0 is the first pixel, 1 is the 2nd pixel, etc.)
-    /// @param data Pointer to the first byte of the image
-    Iterator(int index, unsigned char* data)
-    {
-      assert(sizeof(unsigned char)==1);  // This assumption seems pretty safe
-      m_ptr = data + (index>>3);  // index>>3 <==> indx / 8
-      m_bit = 0x80 >> (index & 0x07);  // index & 0x07 <==> index % 8
-    }
-    /// Okay to call these constructors
-    Iterator() : m_ptr(0), m_bit(0) {}
-    Iterator(const Iterator& other) : m_ptr(other.m_ptr), m_bit(other.m_bit) {}
-    ~Iterator() {}
-    Iterator& operator=(const Iterator& other) { m_ptr=other.m_ptr;  m_bit=other.m_bit;  return *this; }
-    Pixel operator*() const { return GetValue(); }
-    PixelRef operator*() { return PixelRef(*this); }
-    bool operator==(const Iterator& other) { return (m_ptr==other.m_ptr && m_bit==other.m_bit); }
-    bool operator!=(const Iterator& other) { return (m_ptr!=other.m_ptr || m_bit!=other.m_bit); }
-    Iterator& operator++()    { if (m_bit == 0x01)  { m_ptr++;  m_bit = 0x80; } else m_bit >>= 1;  return *this; }  ///< prefix increment (++p)
-    Iterator  operator++(int) { Iterator tmp=*this;  ++(*this);  return tmp; }  ///< postfix increment (p++)
-    Iterator& operator--()    { if (m_bit == 0x80)  { m_ptr--;  m_bit=0x01; } else m_bit <<= 1;  return *this; }  ///< prefix decrement (--p)
-    Iterator  operator--(int) { Iterator tmp=*this;  --(*this);  return tmp; }  ///< postfix decrement (p--)
-    Iterator& operator+=(int offset) { m_ptr += (offset>>3);  for (int i=(offset&0x07) ; i>0 ; i--)  ++(*this);  return *this; }
-    Iterator& operator-=(int offset) { m_ptr -= (offset>>3);  for (int i=(offset&0x07) ; i>0 ; i--)  --(*this);  return *this; }
-    Iterator operator+(int offset) const { Iterator tmp = *this;  tmp += offset;  return tmp; }
-    Iterator operator-(int offset) const { Iterator tmp = *this;  tmp -= offset;  return tmp; }
-  private:
-    // Only allow PixelRef to call GetValue or SetValue
-    friend PixelRef;
-    Pixel GetValue() const { return ((*m_ptr) & m_bit) != 0; }
-    void SetValue(Pixel val) { if (val) *m_ptr = *m_ptr | m_bit;  else *m_ptr = *m_ptr & (~m_bit); }
-  private:
-    friend class ConstIterator;  // allow ConstIterator to copy these
-    unsigned char* m_ptr;
-    int m_bit;
-  };
-
-  /// A const iterator that disallows setting of values.
-  class ConstIterator 
-  {
-  public:
-    /// You should generally let Image<bool>::Begin() call this constructor
-    /// rather than calling it directly.
-    ConstIterator(int index, const unsigned char* data)
-    {
-      assert(sizeof(unsigned char)==1);  // This assumption seems pretty safe
-      m_ptr = data + (index>>3);  // index>>3 <==> indx / 8
-      m_bit = 0x80 >> (index & 0x07);  // index & 0x07 <==> index % 8
-    }
-    /// Okay to call these constructors
-    ConstIterator() : m_ptr(0), m_bit(0) {}
-    ConstIterator(const ConstIterator& other) : m_ptr(other.m_ptr), m_bit(other.m_bit) {}
-    ConstIterator(const Iterator& other) : m_ptr(other.m_ptr), m_bit(other.m_bit) {}
-    ~ConstIterator() {}
-    ConstIterator& operator=(const ConstIterator& other) { m_ptr=other.m_ptr;  m_bit=other.m_bit;  return *this; }
-    Pixel operator*() const { return GetValue(); }
-    bool operator==(const ConstIterator& other) { return (m_ptr==other.m_ptr && m_bit==other.m_bit); }
-    bool operator!=(const ConstIterator& other) { return (m_ptr!=other.m_ptr || m_bit!=other.m_bit); }
-    ConstIterator& operator++()    { if (m_bit == 0x01)  { m_ptr++;  m_bit = 0x80; } else m_bit >>= 1;  return *this; }  ///< prefix increment (++p)
-    ConstIterator  operator++(int) { ConstIterator tmp=*this;  ++(*this);  return tmp; }  ///< postfix increment (p++)
-    ConstIterator& operator--()    { if (m_bit == 0x80)  { m_ptr--;  m_bit=0x01; } else m_bit <<= 1;  return *this; }  ///< prefix decrement (--p)
-    ConstIterator  operator--(int) { ConstIterator tmp=*this;  --(*this);  return tmp; }  ///< postfix decrement (p--)
-    ConstIterator& operator+=(int offset) { m_ptr += (offset>>3);  for (int i=(offset&0x07) ; i>0 ; i--)  ++(*this);  return *this; }
-    ConstIterator& operator-=(int offset) { m_ptr -= (offset>>3);  for (int i=(offset&0x07) ; i>0 ; i--)  --(*this);  return *this; }
-    ConstIterator  operator+(int offset) const { ConstIterator tmp = *this;  tmp += offset;  return tmp; }
-    ConstIterator  operator-(int offset) const { ConstIterator tmp = *this;  tmp -= offset;  return tmp; }
-  private:
-    // Only allow PixelRef to call GetValue
-    friend PixelRef;
-    Pixel GetValue() const { return ((*m_ptr) & m_bit) != 0; }
-  private:
-    const unsigned char* m_ptr;
-    int m_bit;
-  };
-
-  /// A reference to a binary pixel, allowing getting and setting of values.
-  /// (The implementation of the functions is at the bottom of the file, which
-  /// is necessary because they use the Iterator class, which is not defined 
-  /// until below.)
-  class PixelRef
-  {
-  public:
-    PixelRef(const Iterator& it);
-    PixelRef& operator=(const Pixel& p);
-    operator Pixel() const;
-  private:
-    Iterator m_it;
-  };
-  //@}
-
-public:
-
-  /// @name Constants
-  //@{
-	static const int NBITS_PER_PIXEL;   ///< number of bits per pixel
-	static const int NCHANNELS;        ///< number of channels
-	static const Pixel MIN_VAL;     ///< minimum pixel value 
-	static const Pixel MAX_VAL;     ///< maximum pixel value 
-  //@}
-
-  /// returns the number of bytes used to hold the image data of a binary image.
-  static int GetNBytes(int width, int height)
-  {
-    int npix = width * height;
-    // Note:  npix>>3 <==> npix/8, and index&0x07 <==> index%8
-    return (npix>>3) + ((npix&0x07)==0 ? 0 : 1);
-  }
-
-public:
-  /// Constructor / destructor / copy constructor
-  //@{
-  Image<bool>() : m_data(), m_width(0), m_height(0) { Reset(0, 0); }
-  Image<bool>(int width, int height) : m_data(), m_width(0), m_height(0) { Reset(width, height); }
-  Image<bool>(const Image<bool>& other) : m_data(), m_width(0), m_height(0) { *this = other; }
-  virtual ~Image<bool>() {}
-  //@}
-
-  /// @name Image reinitialization
-  /// After calling Reset(), class object will be in the exact same state as if you 
-  /// were to instantiate a new object by calling the constructor with those parameters.
-  /// Notice that the parameters for Reset() are identical to those for the constructor.
-  //@{
-  void Reset(int width, int height)
-  {
-    m_width = width;
-    m_height = height;
-    int nbytes = GetNBytes(width, height);
-    m_data.Reset(nbytes);
-    m_end = Iterator(Width()*Height(), m_data.Begin()); 
-    m_end_const = ConstIterator(m_end); 
-  }
-  void Reset() { Reset(0,0); }
-  //@}
-
-  /// Assignment operator
-  Image<bool>& operator=(const Image<bool>& other)
-  {
-    m_width = other.m_width;
-    m_height = other.m_height;
-    m_data = other.m_data;
-    m_end = Iterator(Width()*Height(), m_data.Begin()); 
-    m_end_const = ConstIterator(m_end); 
-    return *this;
-  }
-
-public:
-  /// @name Image info
-  //@{
-  int Width()  const { return m_width;  }  ///< Number of pixels in a row
-  int Height() const { return m_height; }  ///< Number of pixels in a column
-  int NBytes() const { return GetNBytes(m_width, m_height); }  ///< Total number of bytes in the image
-  int IsNull() const { return m_width==0 || m_height==0; }  ///< Whether image contains any pixels
-  //@}
-
-  /// @name Pixel accessing functions (inefficient but convenient)
-  //@{
-  Pixel    operator()(int x, int y) const   { return *(Begin(x, y)); }
-  PixelRef operator()(int x, int y)         { return *(Begin(x, y)); }
-  Pixel    operator()(int index) const      { return *(Begin(index)); }
-  PixelRef operator()(int index)            { return *(Begin(index)); }
-  //@}
-
-  /// @name Iterator functions for fast pixel accessing
-  /// Note:  End returns a reference, to avoid expensive copy constructor inside loop;
-  ///        No need to do this for Begin b/c it does not get called often.
-  //@{
-  ConstIterator  Begin() const             { return ConstIterator(0, m_data.Begin()); }  // do not call Begin(0,0) or assert will fire if image is NULL
-  ConstIterator& End()   const             { return const_cast<ConstIterator&>(m_end_const); }
-  ConstIterator  Begin(int x, int y) const { assert(x>=0 && x<m_width && y>=0 && y<m_height);  return ConstIterator(Width()*y+x, m_data.Begin()); }
-  ConstIterator  Begin(int index) const    { assert(index>=0 && index<m_width*m_height);  return ConstIterator(index, m_data.Begin()); }
-  Iterator       Begin()                   { return Iterator(0, m_data.Begin()); }  // do not call Begin(0,0) or assert will fire if image is NULL
-  Iterator&      End()                     { return m_end; } 
-  Iterator       Begin(int x, int y)       { assert(x>=0 && x<m_width && y>=0 && y<m_height);  return Iterator(Width()*y+x, m_data.Begin()); }
-  Iterator       Begin(int index)          { assert(index>=0 && index<m_width*m_height);  return Iterator(index, m_data.Begin()); }
-  //@}
-
-  /// Get pointer to raw data, without convenience of iterator classes
-  //@{
-  const unsigned char* BytePtr()    const { return m_data.Begin(); }
-  unsigned char*       BytePtr()          { return m_data.Begin(); }
-  const unsigned char* BytePtrEnd() const { return m_data.End();   }
-  unsigned char*       BytePtrEnd()       { return m_data.End();   }
-  //@}
-
-private:
-  int m_width, m_height;  //< image dimensions
-  Reallocator<unsigned char> m_data;  //< image data
-  Iterator m_end;  //< points to end (precomputes value for End())
-  ConstIterator m_end_const;  //< points to end (precomputes value for End())
-};
-
-// Implementation of Image<bool>::PixelRef methods
-// (These cannot be defined in the class declaration itself because of circular dependencies.)
-inline Image<bool>::PixelRef::PixelRef(const Iterator& it) : m_it(it) {}
-inline Image<bool>::PixelRef& Image<bool>::PixelRef::operator=(const Pixel& val) { m_it.SetValue(val);  return *this; }
-inline Image<bool>::PixelRef::operator Image<bool>::Pixel() const { return m_it.GetValue(); }
-
-/// A struct to hold three bytes for red, green, and blue color values.
-struct Bgr
-{
-  typedef enum { BLEPO_BGR_XBGR, BLEPO_BGR_XRGB, BLEPO_BGR_GRAY } IntType;
-
-  unsigned char b, g, r;
-  Bgr() : b(0), g(0), r(0) {}
-  /// Constructor from an int
-  /// 'format' governs the interpretation of 'bgr':
-  ///    BLEPO_BGR_XBGR => contains BGR values as 0x00BBGGRR (same as COLORREF)
-  ///    BLEPO_BGR_XRGB => contains BGR values as 0x00RRGGBB
-  ///    BLEPO_BGR_GRAY => contains grayscale values as 0x000000gg (default)
-  explicit Bgr(unsigned int bgr, IntType format) 
-  { 
-    if (format == BLEPO_BGR_XBGR)
-    {  // 0x00BBGGRR
-      r=bgr&0xFF;  bgr>>=8;  g=bgr&0xFF;  bgr>>=8;  b=bgr&0xFF;
-    } 
-    else if (format == BLEPO_BGR_XRGB)
-    {  // 0x00RRGGBB
-      b=bgr&0xFF;  bgr>>=8;  g=bgr&0xFF;  bgr>>=8;  r=bgr&0xFF;
-    }
-    else // BLEPO_BGR_GRAY (default)
-    {  // 0x000000gg (grayscale)
-      b=bgr&0xFF;  g=b;  r=b;
-    } 
-  }
-  explicit Bgr(unsigned char blue, unsigned char green, unsigned char red) : b(blue), g(green), r(red) {}
-  bool operator==(const Bgr& other) const { return b==other.b && g==other.g && r==other.r; }
-  bool operator!=(const Bgr& other) const { return b!=other.b || g!=other.g || r!=other.r; }
-  void FromInt(unsigned int bgr, IntType format)
-  {
-    *this = Bgr(bgr, format);
-  }
-  int ToInt(IntType format) const
-  {
-    if (format == BLEPO_BGR_XBGR)
-    {  // 0x00BBGGRR
-      return (b<<16) | (g<<8) | (r);
-    }
-    else if (format == BLEPO_BGR_XRGB)
-    {  // 0x00RRGGBB
-      return (r<<16) | (g<<8) | (b);
-    }
-    else // BLEPO_BGR_GRAY (default)
-    {  // 0x000000gg (grayscale)
-      return ToGray();
-    } 
-  }
-  unsigned char ToGray() const 
-  { 
-    int val = (1*b + 6*g + 3*r) / 10;
-    if (val < 0)    val = 0;
-    if (val > 255)  val = 255;
-    return val;
-  }
-
-  // built-in colors
-  static Bgr BLUE, GREEN, RED, YELLOW, CYAN, MAGENTA, WHITE, BLACK;
-};
-
-
-/**
-  @class ImgBgr
-    A color image in the blue-green-red (BGR) color space.  Each pixel occupies 3 bytes, 
-    with colors interleaved, i.e., B0G0R0B1G1R1...
-
-  @class ImgBinary
-    A packed binary image with one bit per pixel.
-
-  @class ImgFloat
-    A single-precision floating-point image, with each pixel occupying four bytes.
-
-  @class ImgGray
-    A grayscale image, with each pixel occupying a single byte (unsigned char).
-
-  @class ImgInt
-    An integer image, with each pixel occupying a single integer.  Because integers
-    are machine-dependent, the pixel size is not guaranteed, but it will generally
-    be four bytes on a 32-bit machine.
-
-  @author Stan Birchfield (STB)
-*/
-
-typedef Image<Bgr> ImgBgr;
-typedef Image<float> ImgFloat;
-typedef Image<unsigned char> ImgGray;
-typedef Image<signed int> ImgInt;
-typedef Image<bool> ImgBinary;
-
-};  // end namespace blepo
-
-#endif //__BLEPO_IMAGE_H__
+/* 
+ * Copyright (c) 2004, 2005, 2006, 2007 Clemson University.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __BLEPO_IMAGE_H__
+#define __BLEPO_IMAGE_H__
+
+#include "assert.h"
+#include "Utilities/Reallocator.h"
+#include "FrameArena.h"
+#include "Utilities/PointSizeRect.h"
+#include <stddef.h>  // size_t
+
+namespace blepo
+{
+
+/**
+  @class ImageFileMapping
+  A file of pixels mapped into memory, which is what an Image<T> uses for its 
+  pixels after Image<T>::MapFile() or Image<T>::CreateMappedFile().  The file
+  holds a HEADER_SIZE-byte header (width, height, bytes per pixel, and pixel type) followed 
+  by the pixels in row-major order with no padding, so the pixels are aligned on
+  a HEADER_SIZE-byte boundary.  The operating system pages the pixels in and 
+  out on demand, so an image larger than physical memory can be processed, and 
+  several processes that map the same file writable share the same pixels.
+
+  Normally not used directly.
+
+  @author Stan Birchfield (STB)
+*/
+
+class ImageFileMapping
+{
+public:
+  enum { HEADER_SIZE = 64 };
+  ImageFileMapping() : m_view(0), m_nbytes(0), m_file(0), m_map(0) {}
+  ~ImageFileMapping() { Close(); }
+
+  /// Creates (or truncates) the file, and maps it writable.  'pixel_type' is
+  /// a MappedPixelType<T>::TAG.
+  void Create(const char* filename, int width, int height, int pixel_size, int pixel_type);
+  /// Maps an existing file, checking that its pixels are 'pixel_size' bytes of
+  /// type 'pixel_type'.  If 'writable' is false, changes to the pixels are private 
+  /// to this process and are never written to the file.
+  void Open(const char* filename, int pixel_size, int pixel_type, bool writable, int* width, int* height);
+  void Close();
+  /// Writes any changed pages to the file
+  void Flush();
+
+  void* Pixels() const { return m_view ? static_cast<unsigned char*>(m_view) + HEADER_SIZE : 0; }
+
+private:
+  ImageFileMapping(const ImageFileMapping&);  // not implemented
+  ImageFileMapping& operator=(const ImageFileMapping&);  // not implemented
+  void iMap(const char* filename, size_t nbytes, bool create, bool writable);
+
+  void* m_view;     ///< beginning of the mapped file (the header)
+  size_t m_nbytes;  ///< size of the mapped file
+  void* m_file;     ///< file handle (Windows) or file descriptor (elsewhere)
+  void* m_map;      ///< file mapping handle (Windows only)
+};
+
+struct Bgr;
+
+/// Pixel type stored in the header of a mapped image file, so that a file written
+/// as one type is not mapped as another type of the same size (ImgInt as ImgFloat,
+/// say).  Other pixel types have a tag of zero and are checked by size only.
+template <typename T> struct MappedPixelType  { enum { TAG = 0 }; };
+template <> struct MappedPixelType<unsigned char>   { enum { TAG = 1 }; };
+template <> struct MappedPixelType<Bgr>             { enum { TAG = 2 }; };
+template <> struct MappedPixelType<signed int>      { enum { TAG = 3 }; };
+template <> struct MappedPixelType<float>           { enum { TAG = 4 }; };
+template <> struct MappedPixelType<unsigned short>  { enum { TAG = 5 }; };
+template <> struct MappedPixelType<double>          { enum { TAG = 6 }; };
+
+/**
+  @class Image
+
+  Templated base class for an image.  Pixel data are stored in row-major format,
+  with the first pixel aligned on a Reallocator<T>::ALIGNMENT-byte boundary.  By 
+  default the rows are contiguous (Stride()==Width()).  Calling the constructor or
+  Reset() with a 'row_alignment' (32 or 64 bytes, say) pads each row so that every
+  row begins on such a boundary, which allows SIMD code to use full-width aligned 
+  loads on every row with no scalar cleanup.  In that case Begin()..End() spans the
+  padding as well, so code that walks the whole image as one array must either 
+  check IsContiguous() or walk row by row using Begin(0,y) and Stride().
+
+    This base class should work for most image types, such as:
+    Image<unsigned char>    8-bit gray-level images
+    Image<struct { unsigned b,g,r }>    24-bit BGR images
+    Image<float>    single-precision floating-point images
+    Image<int>    gray-level images with sizeof(int) bytes per pixel
+    etc.
+    (But note:  The constructor is not called on the pixels, so do not use a 
+     class as the templated type if intialization of the class is required.)
+
+  Packed binary images (one bit per pixel) require specialization because
+  sizeof(bool)==1, i.e., a bool occupies a byte of memory even though it stores 
+  only a bit.
+
+  @author Stan Birchfield (STB)
+*/
+
+template <typename T>
+class Image
+{
+public:
+  /// @name Typedefs
+  //@{
+  typedef T Pixel;
+  typedef T& PixelRef;
+  typedef T* Iterator;
+  typedef const T* ConstIterator;
+  //@}
+
+  /// @name Constants
+  //@{
+	static const int NBITS_PER_PIXEL;   ///< number of bits per pixel
+	static const int NCHANNELS;        ///< number of channels
+	static const Pixel MIN_VAL;     ///< minimum pixel value 
+	static const Pixel MAX_VAL;     ///< maximum pixel value 
+  //@}
+
+public:
+  /// Constructor / destructor / copy constructor
+  //@{
+  explicit Image()                       : m_width(0), m_height(0), m_stride(0), m_data(), m_mapping(0) {}
+  explicit Image(int width, int height)  : m_width(0), m_height(0), m_stride(0), m_data(), m_mapping(0) { Reset(width, height); }
+  explicit Image(int width, int height, int row_alignment)  : m_width(0), m_height(0), m_stride(0), m_data(), m_mapping(0) { Reset(width, height, row_alignment); }
+  explicit Image(int width, int height, FrameArena* arena)  : m_width(0), m_height(0), m_stride(0), m_data(), m_mapping(0) { Reset(width, height, arena); }
+  Image(const Image& other)   : m_width(0), m_height(0), m_stride(0), m_data(), m_mapping(0) { *this = other; } 
+#ifdef BLEPO_HAS_RVALUE_REFERENCES
+  Image(Image&& other)        : m_width(0), m_height(0), m_stride(0), m_data(), m_mapping(0) { Swap(other); }
+#endif
+  ~Image() { iUnmap(); }
+  //@}
+
+  /// Assignment operator (the copy has the same row padding as 'other')
+  Image& operator=(const Image& other) 
+  { 
+    if (&other == this)  return *this;
+    if (iKeepMapping(other.m_width, other.m_height, other.m_width) && other.IsContiguous())
+    {  // copy the pixels into the file
+      memcpy(m_data.Begin(), other.m_data.Begin(), m_width*m_height*sizeof(T));
+      return *this;
+    }
+    iUnmap();
+    m_width = other.m_width;
+    m_height = other.m_height;
+    m_stride = other.m_stride;
+    m_data = other.m_data;
+    return *this;
+  }
+
+#ifdef BLEPO_HAS_RVALUE_REFERENCES
+  /// Move assignment operator:  takes the pixels of 'other' instead of copying them
+  Image& operator=(Image&& other) { Swap(other);  return *this; }
+#endif
+
+  /// Exchanges the contents of two images without copying any pixels
+  void Swap(Image& other)
+  {
+    int t;
+    t = m_width;  m_width = other.m_width;  other.m_width = t;
+    t = m_height;  m_height = other.m_height;  other.m_height = t;
+    t = m_stride;  m_stride = other.m_stride;  other.m_stride = t;
+    m_data.Swap(other.m_data);
+    ImageFileMapping* m = m_mapping;  m_mapping = other.m_mapping;  other.m_mapping = m;
+  }
+
+  /// @name Reinitialization
+  /// After calling Reset(), the image will be in the exact same state as if you 
+  /// were to instantiate a new object by calling the constructor with those same parameters.
+  /// Notice that the parameters for Reset() are identical to those for the constructor.
+  /// Reset(width, height) on an image that already has those dimensions keeps its 
+  /// pixels (moving the rows of a padded image together, and copying the pixels of a 
+  /// copy-on-write image that is shared), so an image passed as both the input and 
+  /// the output of a function still holds its pixels afterward.
+  /// Memory is reallocated only when the image grows beyond any size it has had
+  /// before, so resetting an image once per frame does not allocate in the steady 
+  /// state; call ShrinkToFit() to release the unused memory.
+  //@{
+  void Reset(int width, int height)
+  {
+    if (iKeepMapping(width, height, width))  return;
+    const bool same_size = (width == m_width && height == m_height);
+    if (same_size && !IsContiguous())
+    {  // same size, so keep the pixels:  move each row down over the padding before it
+      T* p = m_data.Begin();
+      for (int y = 1 ; y < height ; y++)  memmove(p + y*width, p + y*m_stride, width*sizeof(T));
+    }
+    m_width = width;
+    m_height = height;
+    m_stride = width;
+    m_data.Unshare(same_size);
+    m_data.Reset(width*height);
+  }
+  /// Pads each row so that it begins on a 'row_alignment'-byte boundary.  
+  /// 'row_alignment' must be a power of two no larger than Reallocator<T>::ALIGNMENT.
+  void Reset(int width, int height, int row_alignment)
+  {
+    assert(row_alignment > 0 && (row_alignment & (row_alignment-1)) == 0);
+    if (row_alignment > Reallocator<T>::ALIGNMENT)  BLEPO_ERROR("Row alignment is larger than the alignment of the allocator");
+    // smallest number of pixels that is a multiple of row_alignment bytes
+    int a = row_alignment, b = sizeof(T);
+    while (b != 0)  { int t = a % b;  a = b;  b = t; }  // a = gcd(row_alignment, sizeof(T))
+    const int step = row_alignment / a;
+    const int stride = (width + step - 1) / step * step;
+    if (iKeepMapping(width, height, stride))  return;
+    m_width = width;
+    m_height = height;
+    m_stride = stride;
+    m_data.Unshare(false);
+    m_data.Reset(m_stride*height);
+  }
+  /// Takes the pixels from 'arena' rather than from the heap, if the arena has room
+  /// (see FrameArena).  The image must not be used after the arena's next BeginFrame().
+  /// If 'arena' is NULL, this is the same as Reset(width, height).
+  void Reset(int width, int height, FrameArena* arena)
+  {
+    if (iKeepMapping(width, height, width))  return;
+    void* p = arena ? arena->Allocate(width*height*sizeof(T)) : 0;
+    m_width = width;
+    m_height = height;
+    m_stride = width;
+    if (p)  m_data.Attach(static_cast<T*>(p), width*height);
+    else    { m_data.Unshare(false);  m_data.Reset(width*height); }
+  }
+  void Reset() { Reset(0,0); }
+  void ShrinkToFit() { m_data.ShrinkToFit(); }
+  //@}
+
+  /// @name Copy-on-write
+  /// Copy-on-write is off by default.  When it is on, copying the image (by the 
+  /// copy constructor, operator=, or passing by value) shares the pixels instead of 
+  /// copying them, and the copy is also copy-on-write.  The pixels are copied only
+  /// when an image that shares them calls a non-const accessor (Begin(), End(), 
+  /// operator(), BytePtr(), a RectIterator) or is Reset().  Read-only consumers of 
+  /// a frame, which take it as a const image, therefore never copy it.
+  /// Note:  Get any non-const iterators only after copying, because an iterator 
+  /// obtained before the copy points to the pixels that are now shared.
+  //@{
+  void SetCopyOnWrite(bool cow) { m_data.SetCopyOnWrite(cow); }
+  bool IsCopyOnWrite() const { return m_data.IsCopyOnWrite(); }
+  bool IsShared() const { return m_data.IsShared(); }  ///< whether the pixels are shared with another image
+  //@}
+
+  /// @name Memory-mapped pixels
+  /// A mapped image keeps its pixels in a file (see ImageFileMapping) rather than
+  /// on the heap.  The image stays mapped as long as it keeps its dimensions, so
+  /// a library function that writes into a mapped image of the right size, e.g.,
+  /// Smooth(img, &mapped), writes into the file.  Resetting or assigning it to 
+  /// different dimensions (or padded rows) unmaps it, leaving the file as it is,
+  /// and a copy of a mapped image is an ordinary image.
+  //@{
+  /// Creates a file for a 'width' x 'height' image and maps the image onto it.
+  /// If the file cannot be created, the image is left as it was.
+  void CreateMappedFile(const char* filename, int width, int height)
+  {
+    ImageFileMapping* mapping = new ImageFileMapping;
+    try
+    {
+      mapping->Create(filename, width, height, sizeof(T), MappedPixelType<T>::TAG);
+    }
+    catch (...)
+    {
+      delete mapping;
+      throw;
+    }
+    iUnmap();
+    m_mapping = mapping;
+    iAttachMapping(width, height);
+  }
+  /// Maps the image onto a file written by CreateMappedFile() for the same pixel 
+  /// type.  If 'writable' is false, the pixels may still be changed, but the changes
+  /// are not saved.  If the file cannot be mapped, the image is left as it was.
+  void MapFile(const char* filename, bool writable = false)
+  {
+    int width, height;
+    ImageFileMapping* mapping = new ImageFileMapping;
+    try
+    {
+      mapping->Open(filename, sizeof(T), MappedPixelType<T>::TAG, writable, &width, &height);
+    }
+    catch (...)
+    {
+      delete mapping;
+      throw;
+    }
+    iUnmap();
+    m_mapping = mapping;
+    iAttachMapping(width, height);
+  }
+  bool IsMapped() const { return m_mapping != 0; }
+  /// Writes the changed pixels to the file now, rather than when the operating system gets to it
+  void FlushMappedFile() { if (m_mapping)  m_mapping->Flush(); }
+  //@}
+
+  /// Changes the dimensions of the image without changing the elements.
+  /// The number of elements (i.e., width*height) must be the same, and the 
+  ///     rows must not be padded; otherwise this function has no effect.
+  /// Returns true upon success, false otherwise
+  bool Reshape(int width, int height)
+  {
+    if (m_width * m_height == width * height && IsContiguous())
+    {
+      m_width = width;
+      m_height = height;
+      m_stride = width;
+      return true;
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+public:
+  /// @name Image info
+  //@{
+  int Width()  const { return m_width;  }  ///< Number of pixels in a row
+  int Height() const { return m_height; }  ///< Number of pixels in a column
+  int NBytes() const { return m_stride*m_height*sizeof(T); }  ///< Total number of bytes in the image (including any row padding)
+  int IsNull() const { return m_width==0 || m_height==0; }  ///< Whether image contains any pixels
+  int Stride() const { return m_stride; }  ///< Number of pixels from the start of one row to the start of the next
+  int StrideBytes() const { return m_stride*sizeof(T); }  ///< Number of bytes from the start of one row to the start of the next
+  bool IsContiguous() const { return m_stride==m_width; }  ///< Whether the rows are stored without padding
+  //@}
+
+  /// @name Pixel accessing functions (inefficient but convenient)
+  //@{
+  const Pixel& operator()(int x, int y) const   { return *(Begin(x, y)); }
+  Pixel& operator()(int x, int y)               { return *(Begin(x, y)); }
+  const Pixel& operator()(int index) const      { return *(Begin(index)); }
+  Pixel& operator()(int index)                  { return *(Begin(index)); }
+  //@}
+
+  /// @name Iterator functions for fast pixel accessing
+  //@{
+  ConstIterator Begin() const             { return m_data.Begin(); }
+  ConstIterator Begin(int x, int y) const { assert(x>=0 && x<m_width && y>=0 && y<m_height);  return m_data.Begin()+y*m_stride+x; }
+  ConstIterator Begin(int index) const    { assert(index>=0 && index<m_width*m_height);  return m_data.Begin()+iOffset(index); }
+  ConstIterator End() const               { return m_data.End(); }
+  Iterator Begin()                        { return m_data.Begin(); }
+  Iterator Begin(int x, int y)            { assert(x>=0 && x<m_width && y>=0 && y<m_height);  return m_data.Begin()+y*m_stride+x; }
+  Iterator Begin(int index)               { assert(index>=0 && index<m_width*m_height);  return m_data.Begin()+iOffset(index); }
+  Iterator End()                          { return m_data.End(); }
+  //@}
+
+  /// Get pointer to raw data, as unsigned char*
+  //@{
+  const unsigned char* BytePtr()    const { return reinterpret_cast<const unsigned char*>(m_data.Begin()); }
+  unsigned char*       BytePtr()          { return reinterpret_cast<unsigned char*>      (m_data.Begin()); }
+  const unsigned char* BytePtrEnd() const { return reinterpret_cast<const unsigned char*>(m_data.End());   }
+  unsigned char*       BytePtrEnd()       { return reinterpret_cast<unsigned char*>      (m_data.End());   }
+  //@}
+
+  /// RectIterator for iterating through a rectangle of an image
+  /// Example:
+  ///    ImgBgr::RectIterator p = img.BeginRect();
+  ///    while (!p.AtEnd())  *p++;
+  /// Implementation note:  Be sure not to provide an automatic conversion to 
+  /// an Iterator from this class, or someone might accidentally compare with
+  /// the end of the image, as in
+  ///    while (p != img.End())  *p++
+  /// which would yield the wrong behavior with no compile-time warning or error.
+  /// Currently, a compile-time error prevents users from inadvertently making
+  /// this mistake.
+  class RectIterator
+  {
+  public:
+    RectIterator(Image<T>& img, const Rect& rect)
+    {
+      m_p = img.Begin(rect.left, rect.top);
+      m_p_row = m_p + rect.Width();
+      m_p_end = img.Begin(rect.left, rect.bottom-1) + img.Stride();
+      m_skip = img.Stride() - rect.Width();
+      m_img_stride = img.Stride();
+    }
+    Pixel& operator*() const { return *m_p; }
+    /// prefix increment (++p)
+    RectIterator& operator++()    
+    { 
+      m_p++;
+      if (m_p == m_p_row)  { m_p += m_skip;  m_p_row += m_img_stride; }
+      return *this; 
+    }
+    /// postfix increment (p++)
+    RectIterator  operator++(int) { RectIterator tmp=*this;  ++(*this);  return tmp; }  
+    bool AtEnd() const { return m_p == m_p_end; }
+  private:
+    Iterator m_p, m_p_row, m_p_end;
+    int m_skip, m_img_stride;
+  };
+
+  class ConstRectIterator
+  {
+  public:
+    ConstRectIterator(const Image<T>& img, const Rect& rect)
+    {
+      m_p = img.Begin(rect.left, rect.top);
+      m_p_row = m_p + rect.Width();
+      m_p_end = img.Begin(rect.left, rect.bottom-1) + img.Stride();
+      m_skip = img.Stride() - rect.Width();
+      m_img_stride = img.Stride();
+    }
+    const Pixel& operator*() const { return *m_p; }
+    /// prefix increment (++p)
+    ConstRectIterator& operator++()    
+    { 
+      m_p++;
+      if (m_p == m_p_row)  { m_p += m_skip;  m_p_row += m_img_stride; }
+      return *this; 
+    }
+    /// postfix increment (p++)
+    ConstRectIterator  operator++(int) { ConstRectIterator tmp=*this;  ++(*this);  return tmp; }  
+    bool AtEnd() const { return m_p == m_p_end; }
+  private:
+    ConstIterator m_p, m_p_row, m_p_end;
+    int m_skip, m_img_stride;
+  };
+
+  RectIterator BeginRect(const Rect& rect) { return RectIterator(*this, rect); }
+  ConstRectIterator BeginRect(const Rect& rect) const { return ConstRectIterator(*this, rect); }
+
+private:
+  /// offset of the pixel with the given (row-major) index, skipping any row padding
+  int iOffset(int index) const { return (m_stride==m_width) ? index : (index/m_width)*m_stride + index%m_width; }
+
+  void iAttachMapping(int width, int height)
+  {
+    m_width = width;
+    m_height = height;
+    m_stride = width;
+    m_data.Attach(static_cast<T*>(m_mapping->Pixels()), width*height);
+  }
+  /// Whether the image is mapped and already has these dimensions; if it is 
+  /// mapped with other dimensions, unmaps it.
+  bool iKeepMapping(int width, int height, int stride)
+  {
+    if (m_mapping == 0)  return false;
+    if (width == m_width && height == m_height && stride == m_stride)  return true;
+    iUnmap();
+    return false;
+  }
+  void iUnmap()
+  {
+    if (m_mapping == 0)  return;
+    Reallocator<T> mapped;  // takes the pointer into the file, which it does not free
+    mapped.SetCopyOnWrite(m_data.IsCopyOnWrite());
+    m_data.Swap(mapped);
+    delete m_mapping;
+    m_mapping = 0;
+    m_width = m_height = m_stride = 0;
+  }
+
+  int m_width, m_height;  ///< image dimensions
+  int m_stride;           ///< number of pixels (including padding) from one row to the next
+  Reallocator<T> m_data;  //< image data
+  ImageFileMapping* m_mapping;  ///< file holding the pixels, or NULL if they are on the heap
+};
+
+
+/**
+  @class Image<bool>
+  Specialization for a packed binary image, with one bit per pixel.  The first pixel 
+  is stored in the most significant bit of the first byte, the second pixel in the 
+  next bit, and so on.  If Width()*Height() is not divisible by 8, then the final 
+  byte will contain some unused bits (in its least significant bits).  
+
+  The interface of this class is exactly the same as the other image classes.  The
+  only exception is that sizeof(Image<bool>::Pixel) returns sizeof(bool)=1 byte, 
+  which is incorrect because only one bit per pixel is actually used.  It is this
+  inconsistency in the native bool datatype that causes the code to be so complicated.
+  Keep in mind that the packed bytes can be accessed directly using the BytePtr() 
+  functions.
+  
+  Allow me to say a word about the ordering of the pixels in the packed bytes.  The 
+  ordering described above seems to be the most natural representation because 
+     (1) pixels with smaller coordinates are stored in lower memory addresses,
+         i.e., the first byte of the allocated block of memory contains the first
+         eight pixels of the image; and
+     (2) a bit shift right causes pixels to be shifted to the right.
+
+  Unfortunately, this choice has a drawback.  Intel processors use the little-endian 
+  format, which means that when a word of memory is loaded into a register, the byte at
+  the low memory address is stored in the low byte of the word.  For example, suppose
+  the first two bytes of our image look like this:
+       A7-A6-A5-A4-A3-A2-A1-A0-B7-B6-B5-B4-B3-B2-B1-B0,
+  where A0 is the least significant bit of the first byte, and B0 the least 
+  significant bit of the second byte.  Loading the word (i.e., the 16 bits containing 
+  A and B) into a register yields the following contents for the register:
+       B7-B6-B5-B4-B3-B2-B1-B0-A7-A6-A5-A4-A3-A2-A1-A0
+  because byte A is stored at the lower memory address.  The problem here is that B0 
+  and A7 are now adjacent in the register, even though they are not adjacent in the 
+  image.  As a result, a bit shift in the register will cause artifacts at the byte 
+  boundary.  The same problem occurs at all the byte boundaries after loading 
+  a double-word (32 bits), quad-word (64 bits), or double-quad-word (128 bits).
+    
+  The only way to fix this problem is to discard one of the two goals above.  For
+  example, we could store the image backward, with the last eight pixels of the image 
+  in the first allocated block.  Incrementing the pointer would cause the image to be
+  traversed from right to left and from bottom to top.  This seems unnatural.  
+  Alternatively, we could store the first pixel in the least significant bit of the 
+  first pixel, the second pixel in the bit to its left, and so forth.  One appealing
+  property of this approach is that (in our example above) A0 contains img(0,0), while
+  A1 contains img(1,0), i.e., the indices of the image and the bit line up.  On the
+  other hand, a terrible consequence is that a bit shift right would actually cause
+  the image pixels to shift left, which seems very unnatural indeed.  Although either
+  of these choices could be implemented easily without significantly affecting the
+  user (who would be largely insulated from the underlying representation via the 
+  Iterator class), it is not clear which is the best choice.  
+
+  For clarity, let us define the four choices according to whether traversing the image
+  pixels from the top left to the bottom right either
+     - increases or decreases the bit number (0 to 7)
+     - increases or decreases the byte number (memory address)
+  The four choices are
+    (1) increasing bits, increasing bytes (IBIB)
+        Good:  works for Little Endian machines
+        Bad:   bit shift left actually shifts pixels right
+    (2) increasing bits, decreasing bytes (IBDB)
+        Good:  works for Little Endian machines
+        Bad:   first byte is at end of allocated block
+    (3) decreasing bits, increasing bytes (DBIB)
+        Good:  natural choice
+        Bad:   works for Big Endian machines
+    (4) decreasing bits, decreasing bytes (DBDB)
+        Bad:   first byte is at end of allocated block
+        Bad:   works for Big Endian machines
+        (I.e., DBDB is not a viable option b/c it is altogether bad)
+
+  Examples of the four choices are shown below.  A and B are two 
+  consecutive bytes, and the ellipsis (...) indicates the rest of
+  the pixels in the image.  The values in the four rows above A and
+  B are the indices of the first 16 pixels in the image.
+
+     DBDB: ... 08 09 10 11 12 13 14 15 00 01 02 03 04 05 06 07    
+     IBDB: ... 15 14 13 12 11 10 09 08 07 06 05 04 03 02 01 00    
+     IBIB:     07 06 05 04 03 02 01 00 15 14 13 12 11 10 09 08 ...
+     DBIB:     00 01 02 03 04 05 06 07 08 09 10 11 12 13 14 15 ...
+               A7-A6-A5-A4-A3-A2-A1-A0-B7-B6-B5-B4-B3-B2-B1-B0
+        
+  Note that this is an unsolved problem, because it really becomes an
+  issue only when one wishes to perform bit shifting for the entire image.  
+  In Intel's IPP Library, bit shifting does not extend past byte boundaries,
+  so these issues are not addressed.
+
+  @author Stan Birchfield (STB)
+*/
+
+template <>
+class Image<bool>
+{
+public:
+  typedef bool Pixel;
+
+  /// @name Helper classes, because the bool datatype is not packed.
+  //@{
+  class PixelRef;
+  class ConstIterator;
+
+  /// An iterator pointing to a binary pixel, allowing getting and setting of
+  /// values, as well as incrementing and decrementing the iterator.
+  class Iterator 
+  {
+  public:
+    /// You should generally let Image<bool>::Begin() call this constructor
+    /// rather than calling it directly.
+    /// @param index The zero-based one-dimensional index of the pixel to which
+    ///              this iterator points, by treating image as a 1D array using
+    ///              row-major order (i.e., 0 is the first pixel, 1 is the 2nd pixel, etc.)
+    /// @param data Pointer to the first byte of the image
+    Iterator(int index, unsigned char* data)
+    {
+      assert(sizeof(unsigned char)==1);  // This assumption seems pretty safe
+      m_ptr = data + (index>>3);  // index>>3 <==> indx / 8
+      m_bit = 0x80 >> (index & 0x07);  // index & 0x07 <==> index % 8
+    }
+    /// Okay to call these constructors
+    Iterator() : m_ptr(0), m_bit(0) {}
+    Iterator(const Iterator& other) : m_ptr(other.m_ptr), m_bit(other.m_bit) {}
+    ~Iterator() {}
+    Iterator& operator=(const Iterator& other) { m_ptr=other.m_ptr;  m_bit=other.m_bit;  return *this; }
+    Pixel operator*() const { return GetValue(); }
+    PixelRef operator*() { return PixelRef(*this); }
+    bool operator==(const Iterator& other) { return (m_ptr==other.m_ptr && m_bit==other.m_bit); }
+    bool operator!=(const Iterator& other) { return (m_ptr!=other.m_ptr || m_bit!=other.m_bit); }
+    Iterator& operator++()    { if (m_bit == 0x01)  { m_ptr++;  m_bit = 0x80; } else m_bit >>= 1;  return *this; }  ///< prefix increment (++p)
+    Iterator  operator++(int) { Iterator tmp=*this;  ++(*this);  return tmp; }  ///< postfix increment (p++)
+    Iterator& operator--()    { if (m_bit == 0x80)  { m_ptr--;  m_bit=0x01; } else m_bit <<= 1;  return *this; }  ///< prefix decrement (--p)
+    Iterator  operator--(int) { Iterator tmp=*this;  --(*this);  return tmp; }  ///< postfix decrement (p--)
+    Iterator& operator+=(int offset) { m_ptr += (offset>>3);  for (int i=(offset&0x07) ; i>0 ; i--)  ++(*this);  return *this; }
+    Iterator& operator-=(int offset) { m_ptr -= (offset>>3);  for (int i=(offset&0x07) ; i>0 ; i--)  --(*this);  return *this; }
+    Iterator operator+(int offset) const { Iterator tmp = *this;  tmp += offset;  return tmp; }
+    Iterator operator-(int offset) const { Iterator tmp = *this;  tmp -= offset;  return tmp; }
+  private:
+    // Only allow PixelRef to call GetValue or SetValue
+    friend PixelRef;
+    Pixel GetValue() const { return ((*m_ptr) & m_bit) != 0; }
+    void SetValue(Pixel val) { if (val) *m_ptr = *m_ptr | m_bit;  else *m_ptr = *m_ptr & (~m_bit); }
+  private:
+    friend class ConstIterator;  // allow ConstIterator to copy these
+    unsigned char* m_ptr;
+    int m_bit;
+  };
+
+  /// A const iterator that disallows setting of values.
+  class ConstIterator 
+  {
+  public:
+    /// You should generally let Image<bool>::Begin() call this constructor
+    /// rather than calling it directly.
+    ConstIterator(int index, const unsigned char* data)
+    {
+      assert(sizeof(unsigned char)==1);  // This assumption seems pretty safe
+      m_ptr = data + (index>>3);  // index>>3 <==> indx / 8
+      m_bit = 0x80 >> (index & 0x07);  // index & 0x07 <==> index % 8
+    }
+    /// Okay to call these constructors
+    ConstIterator() : m_ptr(0), m_bit(0) {}
+    ConstIterator(const ConstIterator& other) : m_ptr(other.m_ptr), m_bit(other.m_bit) {}
+    ConstIterator(const Iterator& other) : m_ptr(other.m_ptr), m_bit(other.m_bit) {}
+    ~ConstIterator() {}
+    ConstIterator& operator=(const ConstIterator& other) { m_ptr=other.m_ptr;  m_bit=other.m_bit;  return *this; }
+    Pixel operator*() const { return GetValue(); }
+    bool operator==(const ConstIterator& other) { return (m_ptr==other.m_ptr && m_bit==other.m_bit); }
+    bool operator!=(const ConstIterator& other) { return (m_ptr!=other.m_ptr || m_bit!=other.m_bit); }
+    ConstIterator& operator++()    { if (m_bit == 0x01)  { m_ptr++;  m_bit = 0x80; } else m_bit >>= 1;  return *this; }  ///< prefix increment (++p)
+    ConstIterator  operator++(int) { ConstIterator tmp=*this;  ++(*this);  return tmp; }  ///< postfix increment (p++)
+    ConstIterator& operator--()    { if (m_bit == 0x80)  { m_ptr--;  m_bit=0x01; } else m_bit <<= 1;  return *this; }  ///< prefix decrement (--p)
+    ConstIterator  operator--(int) { ConstIterator tmp=*this;  --(*this);  return tmp; }  ///< postfix decrement (p--)
+    ConstIterator& operator+=(int offset) { m_ptr += (offset>>3);  for (int i=(offset&0x07) ; i>0 ; i--)  ++(*this);  return *this; }
+    ConstIterator& operator-=(int offset) { m_ptr -= (offset>>3);  for (int i=(offset&0x07) ; i>0 ; i--)  --(*this);  return *this; }
+    ConstIterator  operator+(int offset) const { ConstIterator tmp = *this;  tmp += offset;  return tmp; }
+    ConstIterator  operator-(int offset) const { ConstIterator tmp = *this;  tmp -= offset;  return tmp; }
+  private:
+    // Only allow PixelRef to call GetValue
+    friend PixelRef;
+    Pixel GetValue() const { return ((*m_ptr) & m_bit) != 0; }
+  private:
+    const unsigned char* m_ptr;
+    int m_bit;
+  };
+
+  /// A reference to a binary pixel, allowing getting and setting of values.
+  /// (The implementation of the functions is at the bottom of the file, which
+  /// is necessary because they use the Iterator class, which is not defined 
+  /// until below.)
+  class PixelRef
+  {
+  public:
+    PixelRef(const Iterator& it);
+    PixelRef& operator=(const Pixel& p);
+    operator Pixel() const;
+  private:
+    Iterator m_it;
+  };
+  //@}
+
+public:
+
+  /// @name Constants
+  //@{
+	static const int NBITS_PER_PIXEL;   ///< number of bits per pixel
+	static const int NCHANNELS;        ///< number of channels
+	static const Pixel MIN_VAL;     ///< minimum pixel value 
+	static const Pixel MAX_VAL;     ///< maximum pixel value 
+  //@}
+
+  /// returns the number of bytes used to hold the image data of a binary image.
+  static int GetNBytes(int width, int height)
+  {
+    int npix = width * height;
+    // Note:  npix>>3 <==> npix/8, and index&0x07 <==> index%8
+    return (npix>>3) + ((npix&0x07)==0 ? 0 : 1);
+  }
+
+public:
+  /// Constructor / destructor / copy constructor
+  //@{
+  Image<bool>() : m_data(), m_width(0), m_height(0) { Reset(0, 0); }
+  Image<bool>(int width, int height) : m_data(), m_width(0), m_height(0) { Reset(width, height); }
+  Image<bool>(const Image<bool>& other) : m_data(), m_width(0), m_height(0) { *this = other; }
+#ifdef BLEPO_HAS_RVALUE_REFERENCES
+  Image<bool>(Image<bool>&& other) : m_data(), m_width(0), m_height(0) { Reset(0, 0);  Swap(other); }
+#endif
+  virtual ~Image<bool>() {}
+  //@}
+
+  /// @name Image reinitialization
+  /// After calling Reset(), class object will be in the exact same state as if you 
+  /// were to instantiate a new object by calling the constructor with those parameters.
+  /// Notice that the parameters for Reset() are identical to those for the constructor.
+  //@{
+  void Reset(int width, int height)
+  {
+    m_width = width;
+    m_height = height;
+    int nbytes = GetNBytes(width, height);
+    m_data.Reset(nbytes);
+    m_end = Iterator(Width()*Height(), m_data.Begin()); 
+    m_end_const = ConstIterator(m_end); 
+  }
+  void Reset() { Reset(0,0); }
+  void ShrinkToFit() 
+  { 
+    m_data.ShrinkToFit();  
+    m_end = Iterator(Width()*Height(), m_data.Begin()); 
+    m_end_const = ConstIterator(m_end); 
+  }
+  //@}
+
+  /// Assignment operator
+  Image<bool>& operator=(const Image<bool>& other)
+  {
+    m_width = other.m_width;
+    m_height = other.m_height;
+    m_data = other.m_data;
+    m_end = Iterator(Width()*Height(), m_data.Begin()); 
+    m_end_const = ConstIterator(m_end); 
+    return *this;
+  }
+
+#ifdef BLEPO_HAS_RVALUE_REFERENCES
+  /// Move assignment operator:  takes the pixels of 'other' instead of copying them
+  Image<bool>& operator=(Image<bool>&& other) { Swap(other);  return *this; }
+#endif
+
+  /// Exchanges the contents of two images without copying any pixels
+  void Swap(Image<bool>& other)
+  {
+    int t;
+    t = m_width;  m_width = other.m_width;  other.m_width = t;
+    t = m_height;  m_height = other.m_height;  other.m_height = t;
+    m_data.Swap(other.m_data);
+    // the end iterators point into the data, so they must be recomputed rather than swapped
+    m_end = Iterator(Width()*Height(), m_data.Begin()); 
+    m_end_const = ConstIterator(m_end); 
+    other.m_end = Iterator(other.Width()*other.Height(), other.m_data.Begin()); 
+    other.m_end_const = ConstIterator(other.m_end); 
+  }
+
+public:
+  /// @name Image info
+  //@{
+  int Width()  const { return m_width;  }  ///< Number of pixels in a row
+  int Height() const { return m_height; }  ///< Number of pixels in a column
+  int NBytes() const { return GetNBytes(m_width, m_height); }  ///< Total number of bytes in the image
+  int IsNull() const { return m_width==0 || m_height==0; }  ///< Whether image contains any pixels
+  //@}
+
+  /// @name Pixel accessing functions (inefficient but convenient)
+  //@{
+  Pixel    operator()(int x, int y) const   { return *(Begin(x, y)); }
+  PixelRef operator()(int x, int y)         { return *(Begin(x, y)); }
+  Pixel    operator()(int index) const      { return *(Begin(index)); }
+  PixelRef operator()(int index)            { return *(Begin(index)); }
+  //@}
+
+  /// @name Iterator functions for fast pixel accessing
+  /// Note:  End returns a reference, to avoid expensive copy constructor inside loop;
+  ///        No need to do this for Begin b/c it does not get called often.
+  //@{
+  ConstIterator  Begin() const             { return ConstIterator(0, m_data.Begin()); }  // do not call Begin(0,0) or assert will fire if image is NULL
+  ConstIterator& End()   const             { return const_cast<ConstIterator&>(m_end_const); }
+  ConstIterator  Begin(int x, int y) const { assert(x>=0 && x<m_width && y>=0 && y<m_height);  return ConstIterator(Width()*y+x, m_data.Begin()); }
+  ConstIterator  Begin(int index) const    { assert(index>=0 && index<m_width*m_height);  return ConstIterator(index, m_data.Begin()); }
+  Iterator       Begin()                   { return Iterator(0, m_data.Begin()); }  // do not call Begin(0,0) or assert will fire if image is NULL
+  Iterator&      End()                     { return m_end; } 
+  Iterator       Begin(int x, int y)       { assert(x>=0 && x<m_width && y>=0 && y<m_height);  return Iterator(Width()*y+x, m_data.Begin()); }
+  Iterator       Begin(int index)          { assert(index>=0 && index<m_width*m_height);  return Iterator(index, m_data.Begin()); }
+  //@}
+
+  /// Get pointer to raw data, without convenience of iterator classes
+  //@{
+  const unsigned char* BytePtr()    const { return m_data.Begin(); }
+  unsigned char*       BytePtr()          { return m_data.Begin(); }
+  const unsigned char* BytePtrEnd() const { return m_data.End();   }
+  unsigned char*       BytePtrEnd()       { return m_data.End();   }
+  //@}
+
+private:
+  int m_width, m_height;  //< image dimensions
+  Reallocator<unsigned char> m_data;  //< image data
+  Iterator m_end;  //< points to end (precomputes value for End())
+  ConstIterator m_end_const;  //< points to end (precomputes value for End())
+};
+
+// Implementation of Image<bool>::PixelRef methods
+// (These cannot be defined in the class declaration itself because of circular dependencies.)
+inline Image<bool>::PixelRef::PixelRef(const Iterator& it) : m_it(it) {}
+inline Image<bool>::PixelRef& Image<bool>::PixelRef::operator=(const Pixel& val) { m_it.SetValue(val);  return *this; }
+inline Image<bool>::PixelRef::operator Image<bool>::Pixel() const { return m_it.GetValue(); }
+
+/// A struct to hold three bytes for red, green, and blue color values.
+struct Bgr
+{
+  typedef enum { BLEPO_BGR_XBGR, BLEPO_BGR_XRGB, BLEPO_BGR_GRAY } IntType;
+
+  unsigned char b, g, r;
+  Bgr() : b(0), g(0), r(0) {}
+  /// Constructor from an int
+  /// 'format' governs the interpretation of 'bgr':
+  ///    BLEPO_BGR_XBGR => contains BGR values as 0x00BBGGRR (same as COLORREF)
+  ///    BLEPO_BGR_XRGB => contains BGR values as 0x00RRGGBB
+  ///    BLEPO_BGR_GRAY => contains grayscale values as 0x000000gg (default)
+  explicit Bgr(unsigned int bgr, IntType format) 
+  { 
+    if (format == BLEPO_BGR_XBGR)
+    {  // 0x00BBGGRR
+      r=bgr&0xFF;  bgr>>=8;  g=bgr&0xFF;  bgr>>=8;  b=bgr&0xFF;
+    } 
+    else if (format == BLEPO_BGR_XRGB)
+    {  // 0x00RRGGBB
+      b=bgr&0xFF;  bgr>>=8;  g=bgr&0xFF;  bgr>>=8;  r=bgr&0xFF;
+    }
+    else // BLEPO_BGR_GRAY (default)
+    {  // 0x000000gg (grayscale)
+      b=bgr&0xFF;  g=b;  r=b;
+    } 
+  }
+  explicit Bgr(unsigned char blue, unsigned char green, unsigned char red) : b(blue), g(green), r(red) {}
+  bool operator==(const Bgr& other) const { return b==other.b && g==other.g && r==other.r; }
+  bool operator!=(const Bgr& other) const { return b!=other.b || g!=other.g || r!=other.r; }
+  void FromInt(unsigned int bgr, IntType format)
+  {
+    *this = Bgr(bgr, format);
+  }
+  int ToInt(IntType format) const
+  {
+    if (format == BLEPO_BGR_XBGR)
+    {  // 0x00BBGGRR
+      return (b<<16) | (g<<8) | (r);
+    }
+    else if (format == BLEPO_BGR_XRGB)
+    {  // 0x00RRGGBB
+      return (r<<16) | (g<<8) | (b);
+    }
+    else // BLEPO_BGR_GRAY (default)
+    {  // 0x000000gg (grayscale)
+      return ToGray();
+    } 
+  }
+  unsigned char ToGray() const 
+  { 
+    int val = (1*b + 6*g + 3*r) / 10;
+    if (val < 0)    val = 0;
+    if (val > 255)  val = 255;
+    return val;
+  }
+
+  // built-in colors
+  static Bgr BLUE, GREEN, RED, YELLOW, CYAN, MAGENTA, WHITE, BLACK;
+};
+
+
+/**
+  @class ImgBgr
+    A color image in the blue-green-red (BGR) color space.  Each pixel occupies 3 bytes, 
+    with colors interleaved, i.e., B0G0R0B1G1R1...
+
+  @class ImgBinary
+    A packed binary image with one bit per pixel.
+
+  @class ImgFloat
+    A single-precision floating-point image, with each pixel occupying four bytes.
+
+  @class ImgGray
+    A grayscale image, with each pixel occupying a single byte (unsigned char).
+
+  @class ImgInt
+    An integer image, with each pixel occupying a single integer.  Because integers
+    are machine-dependent, the pixel size is not guaranteed, but it will generally
+    be four bytes on a 32-bit machine.
+
+  @class ImgUShort
+    A 16-bit image, with each pixel occupying two bytes (unsigned short).  Used for
+    depth maps and other data with more than 8 but at most 16 bits per pixel, at 
+    half the memory of an ImgInt.
+
+  @class ImgDouble
+    A double-precision floating-point image, with each pixel occupying eight bytes.
+    Used for integral images, which hold integer sums exactly up to 2^53 and so do not 
+    overflow where an ImgInt would.
+
+  @author Stan Birchfield (STB)
+*/
+
+typedef Image<Bgr> ImgBgr;
+typedef Image<float> ImgFloat;
+typedef Image<unsigned char> ImgGray;
+typedef Image<signed int> ImgInt;
+typedef Image<unsigned short> ImgUShort;
+typedef Image<bool> ImgBinary;
+typedef Image<double> ImgDouble;
+
+/**
+  @class ImageView
+  A non-owning window onto pixels stored in row-major format:  a pointer to the
+  first pixel, the dimensions, and the number of pixels from one row to the next.
+  Making a view copies no pixels, so a rectangle of an image can be processed in
+  place instead of being extracted first.  An Image<T> converts implicitly to a
+  view of all its pixels, so functions that take a view accept an image as well.
+
+  A view does not own its pixels:  it is valid only as long as the image it was 
+  made from is neither reset nor destroyed.  Like a pointer, a const view may still
+  be used to modify the pixels; use ConstImageView for read-only access.
+  Views are not provided for the packed ImgBinary.
+
+  @author Stan Birchfield (STB)
+*/
+
+template <typename T>
+class ImageView
+{
+public:
+  typedef T Pixel;
+  typedef T* Iterator;
+  typedef const T* ConstIterator;
+
+  ImageView() : m_first(0), m_width(0), m_height(0), m_stride(0) {}
+  ImageView(T* first, int width, int height, int stride) 
+    : m_first(first), m_width(width), m_height(height), m_stride(stride) { assert(stride >= width); }
+  ImageView(Image<T>& img)
+    : m_first(img.Begin()), m_width(img.Width()), m_height(img.Height()), m_stride(img.Stride()) {}
+  ImageView(Image<T>& img, const Rect& rect)
+    : m_first(0), m_width(rect.Width()), m_height(rect.Height()), m_stride(img.Stride()) 
+  { 
+    assert(rect.left>=0 && rect.top>=0 && rect.right<=img.Width() && rect.bottom<=img.Height());
+    if (!IsNull())  m_first = img.Begin(rect.left, rect.top);
+  }
+
+  int Width()  const { return m_width;  }
+  int Height() const { return m_height; }
+  int Stride() const { return m_stride; }
+  int StrideBytes() const { return m_stride*sizeof(T); }
+  int IsNull() const { return m_width==0 || m_height==0; }
+  bool IsContiguous() const { return m_stride==m_width; }
+
+  Pixel& operator()(int x, int y) const { return *(Begin(x, y)); }
+  Iterator Begin() const { return m_first; }
+  Iterator Begin(int x, int y) const { assert(x>=0 && x<m_width && y>=0 && y<m_height);  return m_first+y*m_stride+x; }
+
+  /// view of a rectangle of this view
+  ImageView SubView(const Rect& rect) const
+  {
+    assert(rect.left>=0 && rect.top>=0 && rect.right<=m_width && rect.bottom<=m_height);
+    if (rect.Width()==0 || rect.Height()==0)  return ImageView();
+    return ImageView(Begin(rect.left, rect.top), rect.Width(), rect.Height(), m_stride);
+  }
+
+private:
+  T* m_first;
+  int m_width, m_height, m_stride;
+};
+
+/// Read-only version of ImageView.  Both Image<T> and ImageView<T> convert to it implicitly.
+template <typename T>
+class ConstImageView
+{
+public:
+  typedef T Pixel;
+  typedef const T* Iterator;
+  typedef const T* ConstIterator;
+
+  ConstImageView() : m_first(0), m_width(0), m_height(0), m_stride(0) {}
+  ConstImageView(const T* first, int width, int height, int stride) 
+    : m_first(first), m_width(width), m_height(height), m_stride(stride) { assert(stride >= width); }
+  ConstImageView(const Image<T>& img)
+    : m_first(img.Begin()), m_width(img.Width()), m_height(img.Height()), m_stride(img.Stride()) {}
+  ConstImageView(const Image<T>& img, const Rect& rect)
+    : m_first(0), m_width(rect.Width()), m_height(rect.Height()), m_stride(img.Stride()) 
+  { 
+    assert(rect.left>=0 && rect.top>=0 && rect.right<=img.Width() && rect.bottom<=img.Height());
+    if (!IsNull())  m_first = img.Begin(rect.left, rect.top);
+  }
+  ConstImageView(const ImageView<T>& view)
+    : m_first(view.Begin()), m_width(view.Width()), m_height(view.Height()), m_stride(view.Stride()) {}
+
+  int Width()  const { return m_width;  }
+  int Height() const { return m_height; }
+  int Stride() const { return m_stride; }
+  int StrideBytes() const { return m_stride*sizeof(T); }
+  int IsNull() const { return m_width==0 || m_height==0; }
+  bool IsContiguous() const { return m_stride==m_width; }
+
+  const Pixel& operator()(int x, int y) const { return *(Begin(x, y)); }
+  ConstIterator Begin() const { return m_first; }
+  ConstIterator Begin(int x, int y) const { assert(x>=0 && x<m_width && y>=0 && y<m_height);  return m_first+y*m_stride+x; }
+
+  /// view of a rectangle of this view
+  ConstImageView SubView(const Rect& rect) const
+  {
+    assert(rect.left>=0 && rect.top>=0 && rect.right<=m_width && rect.bottom<=m_height);
+    if (rect.Width()==0 || rect.Height()==0)  return ConstImageView();
+    return ConstImageView(Begin(rect.left, rect.top), rect.Width(), rect.Height(), m_stride);
+  }
+
+private:
+  const T* m_first;
+  int m_width, m_height, m_stride;
+};
+
+typedef ImageView<Bgr> ViewBgr;
+typedef ImageView<float> ViewFloat;
+typedef ImageView<unsigned char> ViewGray;
+typedef ImageView<signed int> ViewInt;
+typedef ConstImageView<Bgr> ConstViewBgr;
+typedef ConstImageView<float> ConstViewFloat;
+typedef ConstImageView<unsigned char> ConstViewGray;
+typedef ConstImageView<signed int> ConstViewInt;
+
+/**
+  @class ImgBgrPlanar
+  A color image stored as three separate planes (structure of arrays) rather than
+  as interleaved Bgr pixels.  Each plane is an ordinary ImgGray, so it can be passed
+  to any grayscale function, and per-channel loops read consecutive bytes, which 
+  lets them run on SIMD registers.  Like all images, each plane starts on an
+  Reallocator<T>::ALIGNMENT-byte boundary.  Use Convert() to go to and from ImgBgr.
+
+  @author Stan Birchfield (STB)
+*/
+class ImgBgrPlanar
+{
+public:
+  ImgBgrPlanar() {}
+  ImgBgrPlanar(int width, int height) { Reset(width, height); }
+
+  void Reset(int width, int height)
+  {
+    m_b.Reset(width, height);
+    m_g.Reset(width, height);
+    m_r.Reset(width, height);
+  }
+  void Reset() { Reset(0,0); }
+
+  int Width()  const { return m_b.Width();  }
+  int Height() const { return m_b.Height(); }
+  int IsNull() const { return m_b.IsNull(); }
+
+  /// @name Planes
+  //@{
+  const ImgGray& B() const { return m_b; }
+  const ImgGray& G() const { return m_g; }
+  const ImgGray& R() const { return m_r; }
+  ImgGray& B() { return m_b; }
+  ImgGray& G() { return m_g; }
+  ImgGray& R() { return m_r; }
+  //@}
+
+  /// Gathers the pixel from the three planes (inefficient but convenient)
+  Bgr operator()(int x, int y) const { return Bgr(m_b(x, y), m_g(x, y), m_r(x, y)); }
+
+private:
+  ImgGray m_b, m_g, m_r;
+};
+
+};  // end namespace blepo
+
+#endif //__BLEPO_IMAGE_H__
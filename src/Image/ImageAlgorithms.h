@@ -170,8 +170,10 @@ int MeanShiftSegmentation(const ImgBgr& img, ImgInt* out_labels, ImgBgr* out_mea
 //  Returns the number of components found.
 //
 int FHGraphSegmentation(const ImgBgr& img, float sigma, float k, int min_size, ImgInt *out_labels, ImgBgr *out_pseudocolors);
+int FHGraphSegmentation(const ImgBgrPlanar& img, float sigma, float k, int min_size, ImgInt *out_labels, ImgBgr *out_pseudocolors);
 
 int FHGraphSegmentDepth(const ImgBgr& img, const ImgGray& depth, float sigma, float k, int min_size, ImgInt *out_labels, ImgBgr *out_pseudocolors);
+int FHGraphSegmentDepth(const ImgBgr& img, const ImgUShort& depth, float sigma, float k, int min_size, ImgInt *out_labels, ImgBgr *out_pseudocolors);
 
 void RemoveGapsFromLabelImage(const ImgInt& labels, ImgInt* out);
 
@@ -299,6 +301,15 @@ void RealTimeStereo(const ImgGray& img_left, const ImgGray& img_right, ImgGray*
 
 void HistogramGray(const ImgGray& img,const int bin, std::vector<int>* out);
 void HistogramBinary(const ImgGray& img,int* white, int* black);
+// Otsu's method on a histogram (e.g., from HistogramGray):  returns the bin 't' that splits the
+// bins into classes [0,t) and [t,nbins) with the largest between-class variance.
+// OtsuThresholds() is the multi-level version, which returns 'nthresholds' bins t0 < t1 < ...
+// that split the bins into classes [0,t0), [t0,t1), ..., [t(n-1),nbins).  (see Histogram.cpp)
+int OtsuThreshold(const std::vector<int>& hist);
+void OtsuThresholds(const std::vector<int>& hist, int nthresholds, std::vector<int>* thresholds);
+// Clamps each pixel between the smallest and largest of the other pixels in its window, which
+// extends win_width/2 pixels to either side and win_height/2 pixels above and below; pixels 
+// outside the image are taken from the nearest border pixel.  (see Histogram.cpp)
 void ConservativeSmoothing(const ImgGray& img,  const int win_width,const int win_height, ImgGray* out);
 void ConservativeSmoothing(const ImgFloat& img,  const int win_width,const int win_height, ImgFloat* out);
 void ConservativeSmoothing(const ImgInt& img,  const int win_width,const int win_height, ImgInt* out);
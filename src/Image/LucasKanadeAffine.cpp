@@ -19,7 +19,7 @@
 #pragma warning( disable: 4786 )
 
 #include "ImageAlgorithms.h"
-#include "ImageOperations.h"  // Interp
+#include "ImageOperations.h"  // InterpN
 #include "Matrix/MatrixOperations.h"
 #include "Matrix/LinearAlgebra.h"  // SolveLinear
 #include "Utilities/Math.h"  // SolveLinear
@@ -198,6 +198,34 @@ void iGetRatioOOB(
 		*ratio = (countOOB/((float) in.size()));
 }
 
+// Bilinear interpolation of 'img' at every location, or zero at the locations outside the image
+void iInterpLocations(
+  const ImgFloat& img,
+  const std::vector<PairFloat>& loc,
+  std::vector<float>* val)
+{
+  const int n = (int) loc.size();
+  val->resize(n);
+  if (n == 0)  return;
+  std::vector<float> xs(n), ys(n);
+  int k;
+  for (k=0 ; k<n ; k++)
+  {
+    xs[k] = loc[k].x;
+    ys[k] = loc[k].y;
+  }
+  InterpN(img, &xs[0], &ys[0], n, &(*val)[0]);
+
+  const float xlim = (float) img.Width();
+  const float ylim = (float) img.Height();
+  for (k=0 ; k<n ; k++)
+  {
+    if( !( (xs[k] >= 0.0f) && (xs[k] <= (xlim-1.0f)) &&
+           (ys[k] >= 0.0f) && (ys[k] <= (ylim-1.0f)) ) )
+      (*val)[k] = 0.0f;
+  }
+}
+
 void iGetIntensityDifference(
   const ImgFloat& img1,
   const ImgFloat& img2,
@@ -207,29 +235,11 @@ void iGetIntensityDifference(
 {
   assert(loc1.size() == loc2.size());
   
-  const float xlim = (float) img1.Width();
-  const float ylim = (float) img1.Height();
-
-  float I1, I2;
-  std::vector<PairFloat>::const_iterator i,j;
-  j = loc2.begin();
-  for(i=loc1.begin(); i!=loc1.end(); i++)
-  {
-    if( ((i->x) >= 0.0f) && ((i->x) <= (xlim-1.0f)) &&
-        ((i->y) >= 0.0f) && ((i->y) <= (ylim-1.0f)) )
-      I1 = Interp(img1, i->x, i->y);
-    else
-      I1 = 0.0f;
-
-    if( ((j->x) >= 0.0f) && ((j->x) <= (xlim-1.0f)) &&
-        ((j->y) >= 0.0f) && ((j->y) <= (ylim-1.0f)) )
-      I2 = Interp(img2, j->x, j->y);
-    else
-      I2 = 0.0f; 
-
-    intdiff->push_back(I1-I2);
-    j++;
-  }
+  std::vector<float> I1, I2;
+  iInterpLocations(img1, loc1, &I1);
+  iInterpLocations(img2, loc2, &I2);
+  for (unsigned int k=0 ; k<I1.size() ; k++)
+    intdiff->push_back(I1[k]-I2[k]);
 }
 
 void iGetGradientVectors(
@@ -238,25 +248,15 @@ void iGetGradientVectors(
   const std::vector<PairFloat>& loc,
   std::vector<PairFloat>* grad)
 {
-  const float xlim = (float) gradx.Width();
-  const float ylim = (float) gradx.Height();
-  
+  std::vector<float> gx, gy;
+  iInterpLocations(gradx, loc, &gx);
+  iInterpLocations(grady, loc, &gy);
+
   PairFloat g;
-  std::vector<PairFloat>::const_iterator i;
-  for(i=loc.begin(); i!=loc.end(); i++)
+  for (unsigned int k=0 ; k<gx.size() ; k++)
   {
-    if( ((i->x) >= 0.0f) && ((i->x) <= (xlim-1.0f)) &&
-        ((i->y) >= 0.0f) && ((i->y) <= (ylim-1.0f)) )
-    {
-      g.x = Interp(gradx, i->x, i->y);
-      g.y = Interp(grady, i->x, i->y);
-    }
-    else
-    {
-      g.x = 0.0f;
-      g.y = 0.0f;
-    }
-
+    g.x = gx[k];
+    g.y = gy[k];
     grad->push_back(g);
   }
 }
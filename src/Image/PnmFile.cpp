@@ -66,11 +66,11 @@ static void _getNextString(
 
 
 //////////////////////////////////////////////////////////////////////
-// pnmReadHeader
+// _pnmReadHeaderAnyMaxval
 //
-// Reads a pnm header from an open stream.
+// Reads a pnm header from an open stream, accepting any maxval.
 
-void pnmReadHeader(
+static void _pnmReadHeaderAnyMaxval(
    FILE *fp, 
    int *magic, 
    int *ncols, int *nrows, 
@@ -99,7 +99,21 @@ void pnmReadHeader(
    _getNextString(fp, line, length);
    *maxval = atoi(line);
    fread(line, 1, 1, fp); // Read newline which follows maxval
+}
 
+
+//////////////////////////////////////////////////////////////////////
+// pnmReadHeader
+//
+// Reads a pnm header from an open stream.
+
+void pnmReadHeader(
+   FILE *fp, 
+   int *magic, 
+   int *ncols, int *nrows, 
+   int *maxval)
+{
+   _pnmReadHeaderAnyMaxval(fp, magic, ncols, nrows, maxval);
    if (*maxval != 255)
    {
     BLEPO_ERROR(StringEx("(pnmReadHeader) Maxval is %d, not 255", *maxval));  // But does this ever happen?
@@ -467,3 +481,145 @@ void ppmWriteFileRGB(
 }
 
 
+//////////////////////////////////////////////////////////////////////
+// pgm16Read
+//
+// Reads a pgm image with up to 16 bits per pixel from an open stream.
+// Samples are one byte if maxval < 256, otherwise two bytes, most 
+// significant byte first.  Allocates memory if img==NULL.
+
+unsigned short* pgm16Read(
+   FILE *fp,
+   unsigned short *img,
+   int *ncols, int *nrows,
+   int *maxval)
+{
+   unsigned short *ptr;
+   unsigned char *row;
+   int magic, i, j, nbytes;
+   
+   // Read header
+   _pnmReadHeaderAnyMaxval(fp, &magic, ncols, nrows, maxval);
+   if (magic != 5)
+      BLEPO_ERROR(StringEx("(pgm16Read) Magic number is not 'P5', but 'P%d'", magic))
+   if (*maxval < 1 || *maxval > 65535)
+      BLEPO_ERROR(StringEx("(pgm16Read) Maxval is %d, not between 1 and 65535", *maxval))
+   nbytes = (*maxval < 256) ? 1 : 2;
+   
+   // Allocate memory, if necessary, and set pointer
+   if (img == NULL)  {
+      ptr = (unsigned short*) malloc(*ncols * *nrows * sizeof(unsigned short));
+      if (ptr == NULL)  
+         BLEPO_ERROR(StringEx("(pgm16Read) Memory not allocated"))
+   }
+   else
+      ptr = img;
+   
+   // Read binary image data, one row at a time
+   row = (unsigned char*) malloc(*ncols * nbytes);
+   if (row == NULL)  
+      BLEPO_ERROR(StringEx("(pgm16Read) Memory not allocated"))
+   for (j = 0 ; j < *nrows ; j++)  {
+      unsigned short *out = ptr + j * *ncols;
+      fread(row, *ncols * nbytes, 1, fp);
+      if (nbytes == 1)
+         for (i = 0 ; i < *ncols ; i++)  out[i] = row[i];
+      else
+         for (i = 0 ; i < *ncols ; i++)  out[i] = (unsigned short) ((row[2*i] << 8) | row[2*i+1]);
+   }
+   free(row);
+   
+   return ptr;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// pgm16ReadFile
+//
+// Reads an image from a pgm file with up to 16 bits per pixel.  
+// Allocates memory if img==NULL.
+
+unsigned short* pgm16ReadFile(
+   const char *fname,
+   unsigned short *img,
+   int *ncols, int *nrows,
+   int *maxval)
+{
+   unsigned short *ptr;
+   FILE *fp;
+   
+   // Open file
+   if ( (fp = fopen(fname, "rb")) == NULL)
+      BLEPO_ERROR(StringEx("(pgm16ReadFile) Can't open file named '%s' for reading\n", fname))
+   
+   // Read file
+   ptr = pgm16Read(fp, img, ncols, nrows, maxval);
+   
+   // Close file
+   fclose(fp);
+   
+   return ptr;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// pgm16Write
+//
+// Writes a 16-bit pgm image (maxval 65535, most significant byte first) 
+// to an open stream.
+
+void pgm16Write(
+   FILE *fp,
+   const unsigned short *img, 
+   int ncols, 
+   int nrows)
+{
+   unsigned char *row;
+   int i, j;
+   
+   // Write header
+   fprintf(fp, "P5\n");
+   fprintf(fp, "%d %d\n", ncols, nrows);
+   fprintf(fp, "65535\n");
+   
+   // Write binary image data
+   row = (unsigned char*) malloc(ncols * 2);
+   if (row == NULL)  
+      BLEPO_ERROR(StringEx("(pgm16Write) Memory not allocated"))
+   for (j = 0 ; j < nrows ; j++)  {
+      for (i = 0 ; i < ncols ; i++)  {
+         row[2*i]   = (unsigned char) (img[i] >> 8);
+         row[2*i+1] = (unsigned char) (img[i] & 0xFF);
+      }
+      fwrite(row, ncols * 2, 1, fp);
+      img += ncols;
+   }
+   free(row);
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// pgm16WriteFile
+//
+// Writes a 16-bit image to a pgm file.
+
+void pgm16WriteFile(
+   const char *fname, 
+   const unsigned short *img, 
+   int ncols, 
+   int nrows)
+{
+   FILE *fp;
+   
+   // Open file
+   if ( (fp = fopen(fname, "wb")) == NULL)
+      BLEPO_ERROR(StringEx("(pgm16WriteFile) Can't open file named '%s' for writing\n", fname))
+   
+   // Write to file
+   pgm16Write(fp, img, ncols, nrows);
+   
+   // Close file
+   fclose(fp);
+}
+
+
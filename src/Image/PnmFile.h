@@ -93,6 +93,29 @@ void ppmWriteRGB(
      int ncols,
      int nrows);
 
+// Functions for 16-bit pgm images (maxval > 255, two bytes per sample, 
+// most significant byte first).  The readers also accept 8-bit pgm images.
+unsigned short* pgm16ReadFile(
+     const char *fname,
+     unsigned short *img,
+     int *ncols, int *nrows,
+     int *maxval);
+void pgm16WriteFile(
+     const char *fname,
+     const unsigned short *img,
+     int ncols,
+     int nrows);
+unsigned short* pgm16Read(
+     FILE *fp,
+     unsigned short *img,
+     int *ncols, int *nrows,
+     int *maxval);
+void pgm16Write(
+     FILE *fp,
+     const unsigned short *img,
+     int ncols,
+     int nrows);
+
 // Read the header of a file and determine the type and size of the image
 void pnmReadHeader(
      FILE *fp,
@@ -65,6 +65,15 @@ void RealTimeStereo(const ImgGray& img_left, const ImgGray& img_right, ImgGray*
 //  static Figure fig("dispmap left"), fig2("dispmap right"), fig3("dispmap after check");
 //  static Figure fig, fig3;
   if (!IsSameSize(img_left, img_right))  BLEPO_ERROR("Images must be the same size for stereo correspondence");
+  if (!img_left.IsContiguous() || !img_right.IsContiguous())
+  {
+    // the difference images below are computed by walking each image as a single array
+    ImgGray left, right;
+    Extract(img_left, Rect(0, 0, img_left.Width(), img_left.Height()), &left);
+    Extract(img_right, Rect(0, 0, img_right.Width(), img_right.Height()), &right);
+    RealTimeStereo(left, right, disparity_map, max_disp, winsize);
+    return;
+  }
   int i;
 
   disparity_map->Reset(img_left.Width(), img_left.Height());
@@ -82,11 +91,16 @@ void RealTimeStereo(const ImgGray& img_left, const ImgGray& img_right, ImgGray*
 //      mmx_absdiff(p1, p2, po, n_quadwords);
     int n_doublequadwords = nbytes / 16;
     xmm_absdiff(p1, p2, po, n_doublequadwords);
+    // the last nbytes % 16 bytes do not fill an XMM register
+    for (int k = n_doublequadwords * 16 ; k < nbytes ; k++)
+    {
+      int diff = p1[k] - p2[k];
+      po[k] = static_cast<unsigned char>( diff >= 0 ? diff : -diff );
+    }
 
 //    fig2.Draw(abs_diff_left[i]);
-	if(winsize==5)
-		ConvolveBox5x5(abs_diff_left[i], &abs_diff_left[i]);
-	else ConvolveBoxNxN(abs_diff_left[i], &abs_diff_left[i], winsize);
+    // aggregate the costs over the window (zero where the window does not fit)
+    SmoothBox(abs_diff_left[i], (winsize-1)/2, (winsize-1)/2, &abs_diff_left[i]);
 //    fig.Draw(abs_diff_left[i]);
 //    fig.GrabMouseClick();
   }
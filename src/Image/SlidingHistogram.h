@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2005 Clemson University.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __BLEPO_SLIDINGHISTOGRAM_H__
+#define __BLEPO_SLIDINGHISTOGRAM_H__
+
+#include "Image.h"
+#include "Utilities/Math.h"  // Clamp
+#include "Utilities/PointSizeRect.h"
+#include <algorithm>  // std::fill, std::sort, std::unique, std::lower_bound
+#include <assert.h>
+#include <vector>
+
+namespace blepo
+{
+
+/**
+@class SlidingHistogram
+  The histogram of a (2rx+1)x(2ry+1) window that slides over an image, for rank
+  filters (median, min, max, ...) whose cost per pixel does not depend on the size
+  of the window (Perreault and Hebert, "Median filtering in constant time", 2007).
+
+  Every column keeps a histogram of the 2ry+1 pixels of its window, which is updated
+  by one pixel out and one pixel in as the window moves down a row.  The histogram of
+  the window is the sum of 2rx+1 column histograms, and moves right by subtracting one
+  column and adding another.  It keeps both coarse counts, each covering 2^shift bins,
+  and fine counts; the coarse counts are updated at every pixel, but the fine counts
+  of a coarse bin are brought up to date only when a query falls in that bin.
+
+  Pixels outside the image are taken from the nearest border pixel.
+
+  Example (median filter):
+    struct Pixels
+    {
+      const ImgGray* img;
+      int operator()(int x, int y) const { return (*img)(x, y); }
+    };
+    struct Median
+    {
+      ImgGray* out;  int rank;
+      void operator()(int x, int y, SlidingHistogram& hist) { (*out)(x, y) = hist.Select(rank); }
+    };
+    Pixels pixels = { &img };
+    Median median = { &out, (2*rx+1) * (2*ry+1) / 2 };
+    SlidingHistogram hist(256);
+    hist.Slide(pixels, img.Width(), img.Height(), rx, ry, Rect(0, 0, img.Width(), img.Height()), &median);
+*/
+
+class SlidingHistogram
+{
+public:
+  /// Pixel values are bin indices in [0, nvalues).  The coarse bins are chosen to be 
+  /// about as many as the fine bins in each of them.
+  SlidingHistogram(int nvalues)
+    : m_nbins(0), m_ncoarse(0), m_shift(0), m_x(0), m_rx(0), m_x0(0), m_x1(0)
+  {
+    assert(nvalues > 0);
+    while ((1 << (2*m_shift)) < nvalues)  m_shift++;
+    m_ncoarse = (nvalues + (1 << m_shift) - 1) >> m_shift;
+    m_nbins = m_ncoarse << m_shift;
+  }
+
+  /// Visits every pixel (x,y) of 'rect' in raster order, calling (*visit)(x, y, *this)
+  /// with the histogram of the window around the pixel.  'pixels(x,y)' returns the bin
+  /// of pixel (x,y), for 0 <= x < width and 0 <= y < height.
+  template <typename P, typename F>
+  void Slide(const P& pixels, int width, int height, int rx, int ry, const Rect& rect, F* visit)
+  {
+    assert(rx >= 0 && ry >= 0 && 2*ry + 1 <= 0xFFFF);
+    if (rect.Width() <= 0 || rect.Height() <= 0)  return;
+    m_rx = rx;
+    m_x0 = blepo_ex::Max(rect.left - rx, 0);
+    m_x1 = blepo_ex::Min(rect.right + rx, width);
+    const int ncols = m_x1 - m_x0;
+    m_col_coarse.assign(ncols * m_ncoarse, 0);
+    m_col_fine.assign(ncols * m_nbins, 0);
+    m_coarse.resize(m_ncoarse);
+    m_fine.resize(m_nbins);
+    m_fine_x.resize(m_ncoarse);
+
+    // (local copies of the members, which the stores below would otherwise be assumed to alias)
+    const int nbins = m_nbins, ncoarse = m_ncoarse, shift = m_shift, x0 = m_x0, x1 = m_x1;
+    unsigned short* col_coarse = &m_col_coarse[0];
+    unsigned short* col_fine = &m_col_fine[0];
+    int* coarse = &m_coarse[0];
+
+    // column histograms, initialized to the window of the first row
+    for (int j=rect.top-ry ; j<=rect.top+ry ; j++)
+    {
+      const int yy = blepo_ex::Clamp(j, 0, height - 1);
+      for (int c=0 ; c<ncols ; c++)
+      {
+        const int v = pixels(x0 + c, yy);
+        assert(v >= 0 && v < nbins);
+        col_coarse[c * ncoarse + (v >> shift)]++;
+        col_fine[c * nbins + v]++;
+      }
+    }
+
+    for (int y=rect.top ; y<rect.bottom ; y++)
+    {
+      if (y > rect.top)
+      {
+        const int yout = blepo_ex::Clamp(y - ry - 1, 0, height - 1), yin = blepo_ex::Clamp(y + ry, 0, height - 1);
+        for (int c=0 ; c<ncols ; c++)
+        {
+          const int vout = pixels(x0 + c, yout), vin = pixels(x0 + c, yin);
+          assert(vin >= 0 && vin < nbins);
+          col_coarse[c * ncoarse + (vout >> shift)]--;
+          col_fine[c * nbins + vout]--;
+          col_coarse[c * ncoarse + (vin >> shift)]++;
+          col_fine[c * nbins + vin]++;
+        }
+      }
+
+      // window at the start of the row; the fine counts are all out of date
+      std::fill(coarse, coarse + ncoarse, 0);
+      for (int i=rect.left-rx ; i<=rect.left+rx ; i++)
+      {
+        const unsigned short* c = col_coarse + (blepo_ex::Clamp(i, x0, x1 - 1) - x0) * ncoarse;
+        for (int k=0 ; k<ncoarse ; k++)  coarse[k] += c[k];
+      }
+      std::fill(m_fine_x.begin(), m_fine_x.end(), rect.left - 2*rx - 2);
+      m_x = rect.left;
+      (*visit)(m_x, y, *this);
+
+      for (int x=rect.left+1 ; x<rect.right ; x++)
+      {
+        const unsigned short* leaving  = col_coarse + (blepo_ex::Clamp(x - rx - 1, x0, x1 - 1) - x0) * ncoarse;
+        const unsigned short* entering = col_coarse + (blepo_ex::Clamp(x + rx, x0, x1 - 1) - x0) * ncoarse;
+        for (int k=0 ; k<ncoarse ; k++)  coarse[k] += entering[k] - leaving[k];
+        m_x = x;
+        (*visit)(x, y, *this);
+      }
+    }
+  }
+
+  /// Bin holding the pixel of rank 'rank' (0 = smallest) in the current window
+  int Select(int rank)
+  {
+    int k = 0, below = 0;
+    while (below + m_coarse[k] <= rank)  below += m_coarse[k++];
+    const int* f = UpdateFine(k);
+    int b = 0;
+    while (below + f[b] <= rank)  below += f[b++];
+    return (k << m_shift) + b;
+  }
+
+private:
+
+  // Brings the fine counts of coarse bin 'k' up to date with the window at m_x
+  const int* UpdateFine(int k)
+  {
+    const int nfine = 1 << m_shift, x = m_x, rx = m_rx, x0 = m_x0, x1 = m_x1, nbins = m_nbins;
+    const unsigned short* col_fine = &m_col_fine[k << m_shift];
+    int* f = &m_fine[k << m_shift];
+    if (x - m_fine_x[k] > 2*rx)
+    {
+      std::fill(f, f + nfine, 0);
+      for (int i=x-rx ; i<=x+rx ; i++)
+      {
+        const unsigned short* c = col_fine + (blepo_ex::Clamp(i, x0, x1 - 1) - x0) * nbins;
+        for (int b=0 ; b<nfine ; b++)  f[b] += c[b];
+      }
+    }
+    else
+    {
+      for (int i=m_fine_x[k]+1 ; i<=x ; i++)
+      {
+        const unsigned short* leaving  = col_fine + (blepo_ex::Clamp(i - rx - 1, x0, x1 - 1) - x0) * nbins;
+        const unsigned short* entering = col_fine + (blepo_ex::Clamp(i + rx, x0, x1 - 1) - x0) * nbins;
+        for (int b=0 ; b<nfine ; b++)  f[b] += entering[b] - leaving[b];
+      }
+    }
+    m_fine_x[k] = x;
+    return f;
+  }
+
+private:
+  int m_nbins, m_ncoarse, m_shift;
+  int m_x, m_rx;                       ///< current column, horizontal radius
+  int m_x0, m_x1;                      ///< columns [m_x0, m_x1) have histograms
+  std::vector<unsigned short> m_col_coarse, m_col_fine;  ///< column histograms
+  std::vector<int> m_coarse, m_fine;   ///< window histogram
+  std::vector<int> m_fine_x;           ///< column at which the fine counts of each coarse bin were last updated
+};
+
+/// Replaces the pixels of 'img' by their ranks among the distinct values of the image, 
+/// so that images of any type can be filtered with a SlidingHistogram.  'values' receives 
+/// the distinct values in increasing order.  Returns false, leaving 'ranks' untouched, if 
+/// there are more than 'max_values' of them.
+template <typename T>
+bool ComputeValueRanks(const Image<T>& img, int max_values, std::vector<T>* values, ImgInt* ranks)
+{
+  const int w = img.Width(), h = img.Height();
+  values->clear();
+  values->reserve(w * h);
+  for (int y=0 ; y<h ; y++)  values->insert(values->end(), img.Begin(0, y), img.Begin(0, y) + w);
+  std::sort(values->begin(), values->end());
+  values->erase(std::unique(values->begin(), values->end()), values->end());
+  if (static_cast<int>(values->size()) > max_values)  return false;
+
+  ranks->Reset(w, h);
+  for (int y=0 ; y<h ; y++)
+  {
+    typename Image<T>::ConstIterator p = img.Begin(0, y);
+    ImgInt::Iterator q = ranks->Begin(0, y);
+    for (int x=0 ; x<w ; x++)  q[x] = static_cast<int>(std::lower_bound(values->begin(), values->end(), p[x]) - values->begin());
+  }
+  return true;
+}
+
+};  // end namespace blepo
+
+#endif //__BLEPO_SLIDINGHISTOGRAM_H__
@@ -0,0 +1,214 @@
+/* 
+ * Copyright (c) 2005 Clemson University.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __BLEPO_TILEDIMAGE_H__
+#define __BLEPO_TILEDIMAGE_H__
+
+#include "Image.h"
+#include "Utilities/Reallocator.h"
+#include "Utilities/PointSizeRect.h"
+#include <string.h>  // memcpy()
+
+namespace blepo
+{
+
+/**
+@class TiledImage
+  An image stored as a grid of rectangular tiles rather than as one row after
+  another.  Each tile holds TileWidth() x TileHeight() pixels in row-major order,
+  and the tiles are stored one after another in raster order.  Tiles along the
+  right and bottom edges are allocated at full size; the pixels that fall outside
+  the image are unused.
+
+  In a row-major Image<T>, the pixels above and below a pixel are a whole row away,
+  so a vertical pass over a very large image (tens of thousands of pixels wide)
+  touches a new page, and a new TLB entry, for every pixel.  In a tiled image they
+  are TileWidth() pixels away, so a vertical pass that works one tile column at a
+  time stays in the cache.  Use Convert() to go to and from Image<T>, and
+  TileIterator to visit the tiles, each of which can be used as an ImageView.
+
+  Example:
+    TiledImgFloat tiled;
+    Convert(img, &tiled);
+    SmoothGaussVert5(tiled, &tiled);
+    for (TiledImgFloat::TileIterator t = tiled.BeginTiles() ; !t.AtEnd() ; ++t)
+    {
+      ViewFloat tile = t.GetView();  // pixels t.GetRect() of the image
+      ...
+    }
+
+  @author Stan Birchfield (STB)
+*/
+
+template <typename T>
+class TiledImage
+{
+public:
+  typedef T Pixel;
+  typedef T* Iterator;
+  typedef const T* ConstIterator;
+  enum { DEFAULT_TILE_SIZE = 64 };
+
+public:
+  /// Constructor / destructor / copy constructor
+  //@{
+  TiledImage() : m_width(0), m_height(0), m_tile_width(DEFAULT_TILE_SIZE), m_tile_height(DEFAULT_TILE_SIZE), m_ntiles_x(0), m_ntiles_y(0) {}
+  TiledImage(int width, int height, int tile_width = DEFAULT_TILE_SIZE, int tile_height = DEFAULT_TILE_SIZE)
+    : m_width(0), m_height(0), m_tile_width(0), m_tile_height(0), m_ntiles_x(0), m_ntiles_y(0)
+  {
+    Reset(width, height, tile_width, tile_height);
+  }
+  //@}
+
+  /// @name Reinitialization
+  //@{
+  void Reset(int width, int height, int tile_width = DEFAULT_TILE_SIZE, int tile_height = DEFAULT_TILE_SIZE)
+  {
+    assert(tile_width > 0 && tile_height > 0);
+    m_width = width;
+    m_height = height;
+    m_tile_width = tile_width;
+    m_tile_height = tile_height;
+    m_ntiles_x = (width + tile_width - 1) / tile_width;
+    m_ntiles_y = (height + tile_height - 1) / tile_height;
+    m_data.Reset(m_ntiles_x * m_ntiles_y * TileSize());
+  }
+  void Reset() { Reset(0, 0, m_tile_width, m_tile_height); }
+  //@}
+
+  /// @name Image info
+  //@{
+  int Width()      const { return m_width;  }
+  int Height()     const { return m_height; }
+  int IsNull()     const { return m_width==0 || m_height==0; }
+  int TileWidth()  const { return m_tile_width;  }  ///< also the number of pixels from one row of a tile to the next
+  int TileHeight() const { return m_tile_height; }
+  int TileSize()   const { return m_tile_width * m_tile_height; }  ///< number of pixels from one tile to the next
+  int NTilesX()    const { return m_ntiles_x; }
+  int NTilesY()    const { return m_ntiles_y; }
+  //@}
+
+  /// @name Tile accessing functions
+  //@{
+  /// first pixel of tile (tx, ty)
+  ConstIterator TileBegin(int tx, int ty) const { assert(tx>=0 && tx<m_ntiles_x && ty>=0 && ty<m_ntiles_y);  return m_data.Begin() + (ty*m_ntiles_x + tx)*TileSize(); }
+  Iterator      TileBegin(int tx, int ty)       { assert(tx>=0 && tx<m_ntiles_x && ty>=0 && ty<m_ntiles_y);  return m_data.Begin() + (ty*m_ntiles_x + tx)*TileSize(); }
+  /// pixels of the image covered by tile (tx, ty)
+  Rect TileRect(int tx, int ty) const
+  {
+    const int x0 = tx * m_tile_width, y0 = ty * m_tile_height;
+    return Rect(x0, y0, blepo_ex::Min(x0 + m_tile_width, m_width), blepo_ex::Min(y0 + m_tile_height, m_height));
+  }
+  /// The part of row 'y' that lies in tile column 'tx', i.e., pixels (tx*TileWidth(), y)
+  /// through (tx*TileWidth() + TileWidth() - 1, y).  This is what a vertical pass iterates over.
+  ConstIterator RowBegin(int tx, int y) const { assert(y>=0 && y<m_height);  return TileBegin(tx, y / m_tile_height) + (y % m_tile_height) * m_tile_width; }
+  Iterator      RowBegin(int tx, int y)       { assert(y>=0 && y<m_height);  return TileBegin(tx, y / m_tile_height) + (y % m_tile_height) * m_tile_width; }
+  //@}
+
+  /// @name Pixel accessing functions (inefficient but convenient)
+  //@{
+  const Pixel& operator()(int x, int y) const { assert(x>=0 && x<m_width);  return RowBegin(x / m_tile_width, y)[x % m_tile_width]; }
+  Pixel&       operator()(int x, int y)       { assert(x>=0 && x<m_width);  return RowBegin(x / m_tile_width, y)[x % m_tile_width]; }
+  //@}
+
+  /// Visits the tiles in raster order
+  /// Example:
+  ///    for (TiledImgGray::TileIterator t = img.BeginTiles() ; !t.AtEnd() ; ++t)  total += Sum(t.GetView());
+  class TileIterator
+  {
+  public:
+    TileIterator(TiledImage<T>& img) : m_img(&img), m_tx(0), m_ty(0) {}
+    int TileX() const { return m_tx; }
+    int TileY() const { return m_ty; }
+    Rect GetRect() const { return m_img->TileRect(m_tx, m_ty); }
+    Iterator Begin() const { return m_img->TileBegin(m_tx, m_ty); }
+    /// the pixels of the tile that lie inside the image
+    ImageView<T> GetView() const { Rect r = GetRect();  return ImageView<T>(Begin(), r.Width(), r.Height(), m_img->TileWidth()); }
+    /// prefix increment (++t)
+    TileIterator& operator++() { if (++m_tx == m_img->NTilesX())  { m_tx = 0;  m_ty++; }  return *this; }
+    bool AtEnd() const { return m_ty >= m_img->NTilesY() || m_img->NTilesX() == 0; }
+  private:
+    TiledImage<T>* m_img;
+    int m_tx, m_ty;
+  };
+
+  class ConstTileIterator
+  {
+  public:
+    ConstTileIterator(const TiledImage<T>& img) : m_img(&img), m_tx(0), m_ty(0) {}
+    int TileX() const { return m_tx; }
+    int TileY() const { return m_ty; }
+    Rect GetRect() const { return m_img->TileRect(m_tx, m_ty); }
+    ConstIterator Begin() const { return m_img->TileBegin(m_tx, m_ty); }
+    /// the pixels of the tile that lie inside the image
+    ConstImageView<T> GetView() const { Rect r = GetRect();  return ConstImageView<T>(Begin(), r.Width(), r.Height(), m_img->TileWidth()); }
+    /// prefix increment (++t)
+    ConstTileIterator& operator++() { if (++m_tx == m_img->NTilesX())  { m_tx = 0;  m_ty++; }  return *this; }
+    bool AtEnd() const { return m_ty >= m_img->NTilesY() || m_img->NTilesX() == 0; }
+  private:
+    const TiledImage<T>* m_img;
+    int m_tx, m_ty;
+  };
+
+  TileIterator BeginTiles() { return TileIterator(*this); }
+  ConstTileIterator BeginTiles() const { return ConstTileIterator(*this); }
+
+private:
+  int m_width, m_height;            ///< image dimensions
+  int m_tile_width, m_tile_height;  ///< tile dimensions
+  int m_ntiles_x, m_ntiles_y;       ///< number of tiles in each direction
+  Reallocator<T> m_data;            ///< tiles, one after another
+};
+
+typedef TiledImage<Bgr> TiledImgBgr;
+typedef TiledImage<float> TiledImgFloat;
+typedef TiledImage<unsigned char> TiledImgGray;
+typedef TiledImage<signed int> TiledImgInt;
+
+/// @name Conversion between row-major and tiled images
+/// Converting to a tiled image keeps the tile size of 'out' (DEFAULT_TILE_SIZE
+/// unless 'out' was Reset() with another size).
+//@{
+template <typename T>
+void Convert(const Image<T>& img, TiledImage<T>* out)
+{
+  out->Reset(img.Width(), img.Height(), out->TileWidth(), out->TileHeight());
+  for (int tx=0 ; tx<out->NTilesX() ; tx++)
+  {
+    const int x0 = tx * out->TileWidth();
+    const int n = blepo_ex::Min(out->TileWidth(), img.Width() - x0);
+    for (int y=0 ; y<img.Height() ; y++)  memcpy(out->RowBegin(tx, y), img.Begin(x0, y), n * sizeof(T));
+  }
+}
+
+template <typename T>
+void Convert(const TiledImage<T>& img, Image<T>* out)
+{
+  out->Reset(img.Width(), img.Height());
+  for (int tx=0 ; tx<img.NTilesX() ; tx++)
+  {
+    const int x0 = tx * img.TileWidth();
+    const int n = blepo_ex::Min(img.TileWidth(), img.Width() - x0);
+    for (int y=0 ; y<img.Height() ; y++)  memcpy(out->Begin(x0, y), img.RowBegin(tx, y), n * sizeof(T));
+  }
+}
+//@}
+
+};  // end namespace blepo
+
+#endif //__BLEPO_TILEDIMAGE_H__
@@ -1,71 +1,673 @@
-/* 
- * Copyright (c) 2004 Clemson University.
- *
- * This program is free software; you can redistribute it and/or modify
- * it under the terms of the GNU General Public License as published by
- * the Free Software Foundation; either version 2 of the License, or (at
- * your option) any later version.
- * 
- * This program is distributed in the hope that it will be useful, but
- * WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
- * General Public License for more details.
- * 
- * You should have received a copy of the GNU General Public License
- * along with this program; if not, write to the Free Software
- * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
- */
-
-#include "Quick.h"
-
-
-// -------------------- all includes must go before these lines ------------------
-#if defined(DEBUG) && defined(WIN32) && !defined(NO_MFC)
-#include <afxwin.h>
-#define new DEBUG_NEW
-#undef THIS_FILE
-static char THIS_FILE[] = __FILE__;
-#endif
-// -------------------- all code must go after these lines -----------------------
-
-// ================> begin local functions (available only to this translation unit)
-namespace{
-bool i_can_do_mmx;
-bool i_can_do_sse;
-bool i_can_do_sse2;
-bool i_can_do_sse3;
-//extern "C" int InstructionSet();
-extern "C" int mmx_supported();
-inline void iInit()
-{
-  static bool initialized = false;
-  if (!initialized) 
-  {
-//    int cpu_info = InstructionSet();
-    int cpu_info = mmx_supported();
-    i_can_do_mmx = cpu_info >= 1;
-    i_can_do_sse = cpu_info >= 3;
-    i_can_do_sse2 = cpu_info >= 4;
-    i_can_do_sse3 = cpu_info >= 5;
-    initialized = true;
-  }
-}
-};
-// ================< end local functions
-
-namespace blepo
-{
-
-bool CanDoMmx() { iInit();  return i_can_do_mmx; }
-bool CanDoSse() { iInit();  return i_can_do_sse; }
-bool CanDoSse2() { iInit();  return i_can_do_sse2; }
-bool CanDoSse3() { iInit();  return i_can_do_sse3; }
-
-void TurnOffAllMmxSse()
-{
-  iInit();
-  i_can_do_mmx = i_can_do_sse = i_can_do_sse2 = i_can_do_sse3 = false;
-}
-
-};  // end namespace blepo
-
+/*
+ * Copyright (c) 2004 Clemson University.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Quick.h"
+#include <string.h>  // memcpy, memset
+
+// All of the code paths are compiled, whatever instruction set the compiler targets,
+// and the fastest one is chosen at runtime.  Visual C++ provides every intrinsic 
+// regardless of /arch.  GCC and Clang provide the intrinsics of an instruction set 
+// beyond the one they target (e.g., without -mavx2) only inside a function marked 
+// with BLEPO_QUICK_TARGET.
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define BLEPO_QUICK_X86
+#if defined(_MSC_VER)
+#include <intrin.h>  // __cpuidex, _xgetbv
+#else
+#include <cpuid.h>  // __cpuid_count
+#endif
+#include <immintrin.h>  // SSE2, AVX2, and AVX-512 intrinsics
+#define BLEPO_QUICK_SSE2
+#define BLEPO_QUICK_AVX2
+#if !defined(_MSC_VER) || _MSC_VER >= 1911
+#define BLEPO_QUICK_AVX512
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#define BLEPO_QUICK_TARGET(isa)
+#define BLEPO_QUICK_INLINE __forceinline
+#else
+#define BLEPO_QUICK_TARGET(isa) __attribute__((target(isa)))
+#define BLEPO_QUICK_INLINE inline __attribute__((always_inline))
+#endif
+#if defined(__GNUC__) && !defined(__clang__)
+// The register versions of the byte operations return vectors by value, but they are
+// always inlined into a marked function, so the call ABI that GCC warns about is never used.
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+
+// -------------------- all includes must go before these lines ------------------
+#if defined(DEBUG) && defined(WIN32) && !defined(NO_MFC)
+#include <afxwin.h>
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif
+// -------------------- all code must go after these lines -----------------------
+
+// ================> begin local functions (available only to this translation unit)
+namespace{
+bool i_can_do_mmx;
+bool i_can_do_sse;
+bool i_can_do_sse2;
+bool i_can_do_sse3;
+bool i_can_do_avx2;
+bool i_can_do_avx512;
+
+#ifdef _MSC_VER
+typedef unsigned __int64 iWord;
+#else
+typedef unsigned long long iWord;
+#endif
+
+#ifdef BLEPO_QUICK_X86
+// eax, ebx, ecx, edx returned by the cpuid instruction
+void iCpuid(int leaf, unsigned int regs[4])
+{
+#if defined(_MSC_VER)
+  int r[4];
+  __cpuidex(r, leaf, 0);
+  for (int i=0 ; i<4 ; i++)  regs[i] = static_cast<unsigned int>(r[i]);
+#else
+  __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Which registers the operating system saves on a context switch (XCR0)
+unsigned int iXgetbv()
+{
+#if defined(_MSC_VER)
+  return static_cast<unsigned int>(_xgetbv(0));
+#else
+  unsigned int eax, edx;
+  __asm__ __volatile__ ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return eax;
+#endif
+}
+#endif
+
+inline void iInit()
+{
+  static bool initialized = false;
+  if (!initialized)
+  {
+    i_can_do_mmx = i_can_do_sse = i_can_do_sse2 = i_can_do_sse3 = false;
+    i_can_do_avx2 = i_can_do_avx512 = false;
+#ifdef BLEPO_QUICK_X86
+    unsigned int r[4];
+    iCpuid(0, r);
+    const unsigned int max_leaf = r[0];
+    iCpuid(1, r);
+    i_can_do_mmx  = (r[3] & (1 << 23)) != 0;
+    i_can_do_sse  = (r[3] & (1 << 25)) != 0;
+    i_can_do_sse2 = (r[3] & (1 << 26)) != 0;
+    i_can_do_sse3 = (r[2] & (1 <<  0)) != 0;
+    // AVX registers are usable only if the OS saves them (OSXSAVE, then XCR0)
+    const bool osxsave = (r[2] & (1 << 27)) != 0;
+    const unsigned int xcr0 = osxsave ? iXgetbv() : 0;
+    const bool os_avx    = (xcr0 & 0x06) == 0x06;  // xmm, ymm
+    const bool os_avx512 = (xcr0 & 0xe6) == 0xe6;  // xmm, ymm, opmask, zmm
+    if (max_leaf >= 7)
+    {
+      iCpuid(7, r);
+      i_can_do_avx2   = os_avx && (r[1] & (1 << 5)) != 0;
+      i_can_do_avx512 = os_avx512 && (r[1] & (1 << 16)) != 0 && (r[1] & (1 << 30)) != 0;  // F, BW
+    }
+#endif
+#ifndef BLEPO_QUICK_SSE2
+    i_can_do_sse2 = false;
+#endif
+#ifndef BLEPO_QUICK_AVX2
+    i_can_do_avx2 = false;
+#endif
+#ifndef BLEPO_QUICK_AVX512
+    i_can_do_avx512 = false;
+#endif
+    initialized = true;
+  }
+}
+
+#ifdef BLEPO_QUICK_SSE2
+// ---------------- instruction sets
+// Each struct wraps the byte operations of one register width, so that the loops
+// below are written once and instantiated for SSE2 (16 bytes), AVX2 (32 bytes),
+// and AVX-512 (64 bytes).  Shift counts of 64 or more yield zero, as with the
+// underlying instructions.  Every function that uses the registers is marked with
+// its instruction set, and Run() runs one of the loops below with the loop forced 
+// inline, so that the whole loop is compiled for that instruction set.
+
+struct iSse2
+{
+  typedef __m128i Vec;
+  enum { NBYTES = 16 };
+  BLEPO_QUICK_TARGET("sse2") static Vec Load(const unsigned char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+  BLEPO_QUICK_TARGET("sse2") static void Store(unsigned char* p, Vec a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a); }
+  BLEPO_QUICK_TARGET("sse2") static Vec Set1(unsigned char val) { return _mm_set1_epi8(static_cast<char>(val)); }
+  BLEPO_QUICK_TARGET("sse2") static Vec And(Vec a, Vec b) { return _mm_and_si128(a, b); }
+  BLEPO_QUICK_TARGET("sse2") static Vec Or (Vec a, Vec b) { return _mm_or_si128 (a, b); }
+  BLEPO_QUICK_TARGET("sse2") static Vec Xor(Vec a, Vec b) { return _mm_xor_si128(a, b); }
+  BLEPO_QUICK_TARGET("sse2") static Vec AddSat(Vec a, Vec b) { return _mm_adds_epu8(a, b); }
+  BLEPO_QUICK_TARGET("sse2") static Vec SubSat(Vec a, Vec b) { return _mm_subs_epu8(a, b); }
+  BLEPO_QUICK_TARGET("sse2") static Vec Avg(Vec a, Vec b) { return _mm_avg_epu8(a, b); }  // rounds up
+  BLEPO_QUICK_TARGET("sse2") static Vec CmpEq(Vec a, Vec b) { return _mm_cmpeq_epi8(a, b); }
+  BLEPO_QUICK_TARGET("sse2") static Vec Shl64(Vec a, __m128i count) { return _mm_sll_epi64(a, count); }
+  BLEPO_QUICK_TARGET("sse2") static Vec Shr64(Vec a, __m128i count) { return _mm_srl_epi64(a, count); }
+  BLEPO_QUICK_TARGET("sse2") static __m128i Count(int n) { return _mm_cvtsi32_si128(n); }
+  template <typename Loop> BLEPO_QUICK_TARGET("sse2") static int Run(const Loop& loop) { return loop.template Run<iSse2>(); }
+};
+
+#ifdef BLEPO_QUICK_AVX2
+struct iAvx2
+{
+  typedef __m256i Vec;
+  enum { NBYTES = 32 };
+  BLEPO_QUICK_TARGET("avx2") static Vec Load(const unsigned char* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+  BLEPO_QUICK_TARGET("avx2") static void Store(unsigned char* p, Vec a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a); }
+  BLEPO_QUICK_TARGET("avx2") static Vec Set1(unsigned char val) { return _mm256_set1_epi8(static_cast<char>(val)); }
+  BLEPO_QUICK_TARGET("avx2") static Vec And(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+  BLEPO_QUICK_TARGET("avx2") static Vec Or (Vec a, Vec b) { return _mm256_or_si256 (a, b); }
+  BLEPO_QUICK_TARGET("avx2") static Vec Xor(Vec a, Vec b) { return _mm256_xor_si256(a, b); }
+  BLEPO_QUICK_TARGET("avx2") static Vec AddSat(Vec a, Vec b) { return _mm256_adds_epu8(a, b); }
+  BLEPO_QUICK_TARGET("avx2") static Vec SubSat(Vec a, Vec b) { return _mm256_subs_epu8(a, b); }
+  BLEPO_QUICK_TARGET("avx2") static Vec Avg(Vec a, Vec b) { return _mm256_avg_epu8(a, b); }
+  BLEPO_QUICK_TARGET("avx2") static Vec CmpEq(Vec a, Vec b) { return _mm256_cmpeq_epi8(a, b); }
+  BLEPO_QUICK_TARGET("avx2") static Vec Shl64(Vec a, __m128i count) { return _mm256_sll_epi64(a, count); }
+  BLEPO_QUICK_TARGET("avx2") static Vec Shr64(Vec a, __m128i count) { return _mm256_srl_epi64(a, count); }
+  BLEPO_QUICK_TARGET("avx2") static __m128i Count(int n) { return _mm_cvtsi32_si128(n); }
+  template <typename Loop> BLEPO_QUICK_TARGET("avx2") static int Run(const Loop& loop) { return loop.template Run<iAvx2>(); }
+};
+#endif
+
+#ifdef BLEPO_QUICK_AVX512
+struct iAvx512
+{
+  typedef __m512i Vec;
+  enum { NBYTES = 64 };
+  BLEPO_QUICK_TARGET("avx512f,avx512bw") static Vec Load(const unsigned char* p) { return _mm512_loadu_si512(p); }
+  BLEPO_QUICK_TARGET("avx512f,avx512bw") static void Store(unsigned char* p, Vec a) { _mm512_storeu_si512(p, a); }
+  BLEPO_QUICK_TARGET("avx512f,avx512bw") static Vec Set1(unsigned char val) { return _mm512_set1_epi8(static_cast<char>(val)); }
+  BLEPO_QUICK_TARGET("avx512f,avx512bw") static Vec And(Vec a, Vec b) { return _mm512_and_si512(a, b); }
+  BLEPO_QUICK_TARGET("avx512f,avx512bw") static Vec Or (Vec a, Vec b) { return _mm512_or_si512 (a, b); }
+  BLEPO_QUICK_TARGET("avx512f,avx512bw") static Vec Xor(Vec a, Vec b) { return _mm512_xor_si512(a, b); }
+  BLEPO_QUICK_TARGET("avx512f,avx512bw") static Vec AddSat(Vec a, Vec b) { return _mm512_adds_epu8(a, b); }
+  BLEPO_QUICK_TARGET("avx512f,avx512bw") static Vec SubSat(Vec a, Vec b) { return _mm512_subs_epu8(a, b); }
+  BLEPO_QUICK_TARGET("avx512f,avx512bw") static Vec Avg(Vec a, Vec b) { return _mm512_avg_epu8(a, b); }
+  BLEPO_QUICK_TARGET("avx512f,avx512bw") static Vec CmpEq(Vec a, Vec b) { return _mm512_movm_epi8(_mm512_cmpeq_epi8_mask(a, b)); }
+  BLEPO_QUICK_TARGET("avx512f,avx512bw") static Vec Shl64(Vec a, __m128i count) { return _mm512_sll_epi64(a, count); }
+  BLEPO_QUICK_TARGET("avx512f,avx512bw") static Vec Shr64(Vec a, __m128i count) { return _mm512_srl_epi64(a, count); }
+  BLEPO_QUICK_TARGET("avx512f,avx512bw") static __m128i Count(int n) { return _mm_cvtsi32_si128(n); }
+  template <typename Loop> BLEPO_QUICK_TARGET("avx512f,avx512bw") static int Run(const Loop& loop) { return loop.template Run<iAvx512>(); }
+};
+#endif
+
+#endif // BLEPO_QUICK_SSE2
+
+// ---------------- byte operations
+// Each operation is given once for registers and once for a single byte.  The register
+// version is forced inline, like the loops, so that it is compiled for the caller's
+// instruction set.
+
+struct iAndOp
+{
+  template <typename I> BLEPO_QUICK_INLINE static typename I::Vec Apply(const typename I::Vec& a, const typename I::Vec& b) { return I::And(a, b); }
+  static unsigned char Apply(unsigned char a, unsigned char b) { return a & b; }
+};
+
+struct iOrOp
+{
+  template <typename I> BLEPO_QUICK_INLINE static typename I::Vec Apply(const typename I::Vec& a, const typename I::Vec& b) { return I::Or(a, b); }
+  static unsigned char Apply(unsigned char a, unsigned char b) { return a | b; }
+};
+
+struct iXorOp
+{
+  template <typename I> BLEPO_QUICK_INLINE static typename I::Vec Apply(const typename I::Vec& a, const typename I::Vec& b) { return I::Xor(a, b); }
+  static unsigned char Apply(unsigned char a, unsigned char b) { return a ^ b; }
+};
+
+struct iAbsDiffOp
+{
+  template <typename I> BLEPO_QUICK_INLINE static typename I::Vec Apply(const typename I::Vec& a, const typename I::Vec& b) { return I::Or(I::SubSat(a, b), I::SubSat(b, a)); }
+  static unsigned char Apply(unsigned char a, unsigned char b) { return a > b ? a - b : b - a; }
+};
+
+struct iSumOp
+{
+  template <typename I> BLEPO_QUICK_INLINE static typename I::Vec Apply(const typename I::Vec& a, const typename I::Vec& b) { return I::AddSat(a, b); }
+  static unsigned char Apply(unsigned char a, unsigned char b) { return a + b > 255 ? 255 : a + b; }
+};
+
+struct iSubtractOp
+{
+  template <typename I> BLEPO_QUICK_INLINE static typename I::Vec Apply(const typename I::Vec& a, const typename I::Vec& b) { return I::SubSat(a, b); }
+  static unsigned char Apply(unsigned char a, unsigned char b) { return a > b ? a - b : 0; }
+};
+
+// (a + 2b + c) / 4, rounded down.  Two averages that round down give exactly this
+// value, and each one is pavgb (which rounds up) minus the bit lost by rounding.
+struct iGaussOp
+{
+  template <typename I> BLEPO_QUICK_INLINE static typename I::Vec AvgDown(const typename I::Vec& a, const typename I::Vec& b)
+  {
+    return I::SubSat(I::Avg(a, b), I::And(I::Xor(a, b), I::Set1(1)));
+  }
+  template <typename I> BLEPO_QUICK_INLINE static typename I::Vec Apply(const typename I::Vec& a, const typename I::Vec& b, const typename I::Vec& c) { return AvgDown<I>(AvgDown<I>(a, c), b); }
+  static unsigned char Apply(unsigned char a, unsigned char b, unsigned char c) { return static_cast<unsigned char>((a + 2*b + c) >> 2); }
+};
+
+// |a - c|; the center tap of the Prewitt kernel is zero
+struct iPrewittOp
+{
+  template <typename I> BLEPO_QUICK_INLINE static typename I::Vec Apply(const typename I::Vec& a, const typename I::Vec&, const typename I::Vec& c) { return iAbsDiffOp::Apply<I>(a, c); }
+  static unsigned char Apply(unsigned char a, unsigned char, unsigned char c) { return iAbsDiffOp::Apply(a, c); }
+};
+
+#ifdef BLEPO_QUICK_SSE2
+// ---------------- loops for one instruction set
+// Each loop holds its arguments, and its Run<I>() processes as many whole registers 
+// as fit and returns the number of bytes processed; the caller finishes the rest with
+// a narrower instruction set.  Call a loop through I::Run(), never directly.
+
+template <typename Op>
+struct iBinaryLoop
+{
+  iBinaryLoop(const unsigned char* src1, const unsigned char* src2, unsigned char* dst, int n) : src1(src1), src2(src2), dst(dst), n(n) {}
+  template <typename I> BLEPO_QUICK_INLINE int Run() const
+  {
+    int i = 0;
+    for ( ; i + I::NBYTES <= n ; i += I::NBYTES)
+    {
+      I::Store(dst + i, Op::template Apply<I>(I::Load(src1 + i), I::Load(src2 + i)));
+    }
+    return i;
+  }
+  const unsigned char *src1, *src2;
+  unsigned char* dst;
+  int n;
+};
+
+template <typename Op>
+struct iConstLoop
+{
+  iConstLoop(const unsigned char* src, unsigned char val, unsigned char* dst, int n) : src(src), val(val), dst(dst), n(n) {}
+  template <typename I> BLEPO_QUICK_INLINE int Run() const
+  {
+    const typename I::Vec v = I::Set1(val);
+    int i = 0;
+    for ( ; i + I::NBYTES <= n ; i += I::NBYTES)
+    {
+      I::Store(dst + i, Op::template Apply<I>(I::Load(src + i), v));
+    }
+    return i;
+  }
+  const unsigned char* src;
+  unsigned char val;
+  unsigned char* dst;
+  int n;
+};
+
+template <typename Op>
+struct iTernaryLoop
+{
+  iTernaryLoop(const unsigned char* src1, const unsigned char* src2, const unsigned char* src3, unsigned char* dst, int n) 
+    : src1(src1), src2(src2), src3(src3), dst(dst), n(n) {}
+  template <typename I> BLEPO_QUICK_INLINE int Run() const
+  {
+    int i = 0;
+    for ( ; i + I::NBYTES <= n ; i += I::NBYTES)
+    {
+      I::Store(dst + i, Op::template Apply<I>(I::Load(src1 + i), I::Load(src2 + i), I::Load(src3 + i)));
+    }
+    return i;
+  }
+  const unsigned char *src1, *src2, *src3;
+  unsigned char* dst;
+  int n;
+};
+
+// Erosion or dilation of one row.  The j-th nonzero element of the structuring element
+// has the value 'kernel[j]' and is 'offset[j]' bytes from the pixel under consideration.
+struct iMorphLoop
+{
+  iMorphLoop(const unsigned char* src, const int* offset, const unsigned char* kernel, int nk, bool erode, unsigned char* dst, int n)
+    : src(src), offset(offset), kernel(kernel), nk(nk), erode(erode), dst(dst), n(n) {}
+  template <typename I> BLEPO_QUICK_INLINE int Run() const
+  {
+    typename I::Vec k[9];
+    for (int j=0 ; j<nk ; j++)  k[j] = I::Set1(kernel[j]);
+    const typename I::Vec zero = I::Set1(0), ones = I::Set1(255);
+    int i = 0;
+    for ( ; i + I::NBYTES <= n ; i += I::NBYTES)
+    {
+      typename I::Vec acc = erode ? ones : zero;
+      for (int j=0 ; j<nk ; j++)
+      {
+        typename I::Vec m = I::And(I::Load(src + offset[j] + i), k[j]);
+        acc = erode ? I::And(acc, I::CmpEq(m, k[j])) : I::Or(acc, m);
+      }
+      I::Store(dst + i, erode ? acc : I::Xor(I::CmpEq(acc, zero), ones));
+    }
+    return i;
+  }
+  const unsigned char* src;
+  const int* offset;
+  const unsigned char* kernel;
+  int nk;
+  bool erode;
+  unsigned char* dst;
+  int n;
+};
+
+// Shifts the words [1, nwords) of the bit array upward, from the top down so that
+// src may equal dst.  Returns the number of words at the bottom not yet shifted.
+struct iShiftLeftLoop
+{
+  iShiftLeftLoop(const unsigned char* src, unsigned char* dst, int shift_amount, int nwords) : src(src), dst(dst), shift_amount(shift_amount), nwords(nwords) {}
+  template <typename I> BLEPO_QUICK_INLINE int Run() const
+  {
+    const int step = I::NBYTES / 8;
+    const __m128i up = I::Count(shift_amount), down = I::Count(64 - shift_amount);
+    int k = nwords - step;
+    for ( ; k >= 1 ; k -= step)
+    {
+      typename I::Vec cur = I::Load(src + 8*k), prev = I::Load(src + 8*k - 8);
+      I::Store(dst + 8*k, I::Or(I::Shl64(cur, up), I::Shr64(prev, down)));
+    }
+    return k + step;
+  }
+  const unsigned char* src;
+  unsigned char* dst;
+  int shift_amount, nwords;
+};
+
+// Shifts the words [k, nwords-1) of the bit array downward, from the bottom up so that
+// src may equal dst.  Returns the first word not yet shifted.
+struct iShiftRightLoop
+{
+  iShiftRightLoop(const unsigned char* src, unsigned char* dst, int shift_amount, int k, int nwords) : src(src), dst(dst), shift_amount(shift_amount), k(k), nwords(nwords) {}
+  template <typename I> BLEPO_QUICK_INLINE int Run() const
+  {
+    const int step = I::NBYTES / 8;
+    const __m128i down = I::Count(shift_amount), up = I::Count(64 - shift_amount);
+    int j = k;
+    for ( ; j + step < nwords ; j += step)
+    {
+      typename I::Vec cur = I::Load(src + 8*j), next = I::Load(src + 8*j + 8);
+      I::Store(dst + 8*j, I::Or(I::Shr64(cur, down), I::Shl64(next, up)));
+    }
+    return j;
+  }
+  const unsigned char* src;
+  unsigned char* dst;
+  int shift_amount, k, nwords;
+};
+
+#endif // BLEPO_QUICK_SSE2
+
+// ---------------- dispatch
+// The widest available instruction set goes first, then narrower ones, then plain C++.
+// Turning off MMX/SSE (TurnOffAllMmxSse) leaves only the plain C++.
+
+template <typename Op>
+void iBinary(const unsigned char* src1, const unsigned char* src2, unsigned char* dst, int n)
+{
+  iInit();
+  int i = 0;
+#ifdef BLEPO_QUICK_AVX512
+  if (i_can_do_avx512)  i += iAvx512::Run(iBinaryLoop<Op>(src1 + i, src2 + i, dst + i, n - i));
+#endif
+#ifdef BLEPO_QUICK_AVX2
+  if (i_can_do_avx2)  i += iAvx2::Run(iBinaryLoop<Op>(src1 + i, src2 + i, dst + i, n - i));
+#endif
+#ifdef BLEPO_QUICK_SSE2
+  if (i_can_do_sse2)  i += iSse2::Run(iBinaryLoop<Op>(src1 + i, src2 + i, dst + i, n - i));
+#endif
+  for ( ; i<n ; i++)  dst[i] = Op::Apply(src1[i], src2[i]);
+}
+
+template <typename Op>
+void iConst(const unsigned char* src, unsigned char val, unsigned char* dst, int n)
+{
+  iInit();
+  int i = 0;
+#ifdef BLEPO_QUICK_AVX512
+  if (i_can_do_avx512)  i += iAvx512::Run(iConstLoop<Op>(src + i, val, dst + i, n - i));
+#endif
+#ifdef BLEPO_QUICK_AVX2
+  if (i_can_do_avx2)  i += iAvx2::Run(iConstLoop<Op>(src + i, val, dst + i, n - i));
+#endif
+#ifdef BLEPO_QUICK_SSE2
+  if (i_can_do_sse2)  i += iSse2::Run(iConstLoop<Op>(src + i, val, dst + i, n - i));
+#endif
+  for ( ; i<n ; i++)  dst[i] = Op::Apply(src[i], val);
+}
+
+template <typename Op>
+void iTernary(const unsigned char* src1, const unsigned char* src2, const unsigned char* src3, unsigned char* dst, int n)
+{
+  int i = 0;
+#ifdef BLEPO_QUICK_AVX512
+  if (i_can_do_avx512)  i += iAvx512::Run(iTernaryLoop<Op>(src1 + i, src2 + i, src3 + i, dst + i, n - i));
+#endif
+#ifdef BLEPO_QUICK_AVX2
+  if (i_can_do_avx2)  i += iAvx2::Run(iTernaryLoop<Op>(src1 + i, src2 + i, src3 + i, dst + i, n - i));
+#endif
+#ifdef BLEPO_QUICK_SSE2
+  if (i_can_do_sse2)  i += iSse2::Run(iTernaryLoop<Op>(src1 + i, src2 + i, src3 + i, dst + i, n - i));
+#endif
+  for ( ; i<n ; i++)  dst[i] = Op::Apply(src1[i], src2[i], src3[i]);
+}
+
+// 3x1 filter along each row: dst(x,y) = Op(src(x-1,y), src(x,y), src(x+1,y)) for 0 < x < width-1
+template <typename Op>
+void iFilterHoriz(const unsigned char* src, unsigned char* dst, int width, int height)
+{
+  iInit();
+  if (width < 3)  return;
+  for (int y=0 ; y<height ; y++)
+  {
+    const unsigned char* p = src + y * width;
+    iTernary<Op>(p, p + 1, p + 2, dst + y * width + 1, width - 2);
+  }
+}
+
+// 1x3 filter along each column: dst(x,y) = Op(src(x,y-1), src(x,y), src(x,y+1)) for 0 < y < height-1
+template <typename Op>
+void iFilterVert(const unsigned char* src, unsigned char* dst, int width, int height)
+{
+  iInit();
+  for (int y=1 ; y<height-1 ; y++)
+  {
+    const unsigned char* p = src + y * width;
+    iTernary<Op>(p - width, p, p + width, dst + y * width, width);
+  }
+}
+
+// Erosion (or dilation) with a 3x3 structuring element stored in rows of four bytes,
+// the fourth of which is ignored.  An output pixel is 255 if every (any) nonzero
+// element 'k' of the kernel finds its neighbor 'p' with (p & k) == k ((p & k) != 0),
+// and 0 otherwise.  The one-pixel-wide border around the image is set to zero.
+void iMorph(const unsigned char* src, const unsigned char* kernel, unsigned char* dst, int width, int height, bool erode)
+{
+  iInit();
+  if (width < 3 || height < 3)
+  {
+    memset(dst, 0, width * height);
+    return;
+  }
+  unsigned char k[9];
+  int offset[9];
+  int nk = 0;
+  for (int r=0 ; r<3 ; r++)
+  {
+    for (int c=0 ; c<3 ; c++)
+    {
+      if (kernel[4*r + c] == 0)  continue;
+      k[nk] = kernel[4*r + c];
+      offset[nk++] = (r - 1) * width + (c - 1);
+    }
+  }
+  memset(dst, 0, width);
+  memset(dst + (height - 1) * width, 0, width);
+  for (int y=1 ; y<height-1 ; y++)
+  {
+    const unsigned char* p = src + y * width + 1;
+    unsigned char* q = dst + y * width + 1;
+    const int n = width - 2;
+    int i = 0;
+#ifdef BLEPO_QUICK_AVX512
+    if (i_can_do_avx512)  i += iAvx512::Run(iMorphLoop(p + i, offset, k, nk, erode, q + i, n - i));
+#endif
+#ifdef BLEPO_QUICK_AVX2
+    if (i_can_do_avx2)  i += iAvx2::Run(iMorphLoop(p + i, offset, k, nk, erode, q + i, n - i));
+#endif
+#ifdef BLEPO_QUICK_SSE2
+    if (i_can_do_sse2)  i += iSse2::Run(iMorphLoop(p + i, offset, k, nk, erode, q + i, n - i));
+#endif
+    for ( ; i<n ; i++)
+    {
+      bool on = erode;
+      for (int j=0 ; j<nk ; j++)
+      {
+        const unsigned char m = p[offset[j] + i] & k[j];
+        if (erode)  on = on && m == k[j];
+        else        on = on || m != 0;
+      }
+      q[i] = on ? 255 : 0;
+    }
+    dst[y * width] = dst[y * width + width - 1] = 0;
+  }
+}
+
+iWord iLoadWord(const unsigned char* p) { iWord w;  memcpy(&w, p, sizeof(w));  return w; }
+void iStoreWord(unsigned char* p, iWord w) { memcpy(p, &w, sizeof(w)); }
+
+// Bit i of the array is bit i%64 of word i/64, since x86 is little-endian
+void iShiftLeft(const unsigned char* src, unsigned char* dst, int shift_amount, int nwords)
+{
+  iInit();
+  int m = nwords;
+#ifdef BLEPO_QUICK_AVX512
+  if (i_can_do_avx512)  m = iAvx512::Run(iShiftLeftLoop(src, dst, shift_amount, m));
+#endif
+#ifdef BLEPO_QUICK_AVX2
+  if (i_can_do_avx2)  m = iAvx2::Run(iShiftLeftLoop(src, dst, shift_amount, m));
+#endif
+#ifdef BLEPO_QUICK_SSE2
+  if (i_can_do_sse2)  m = iSse2::Run(iShiftLeftLoop(src, dst, shift_amount, m));
+#endif
+  for (int k=m-1 ; k>=0 ; k--)
+  {
+    const iWord cur = iLoadWord(src + 8*k), prev = (k > 0) ? iLoadWord(src + 8*k - 8) : 0;
+    iWord w;
+    if      (shift_amount == 0)   w = cur;
+    else if (shift_amount >= 64)  w = prev;
+    else                          w = (cur << shift_amount) | (prev >> (64 - shift_amount));
+    iStoreWord(dst + 8*k, w);
+  }
+}
+
+void iShiftRight(const unsigned char* src, unsigned char* dst, int shift_amount, int nwords)
+{
+  iInit();
+  int k = 0;
+#ifdef BLEPO_QUICK_AVX512
+  if (i_can_do_avx512)  k = iAvx512::Run(iShiftRightLoop(src, dst, shift_amount, k, nwords));
+#endif
+#ifdef BLEPO_QUICK_AVX2
+  if (i_can_do_avx2)  k = iAvx2::Run(iShiftRightLoop(src, dst, shift_amount, k, nwords));
+#endif
+#ifdef BLEPO_QUICK_SSE2
+  if (i_can_do_sse2)  k = iSse2::Run(iShiftRightLoop(src, dst, shift_amount, k, nwords));
+#endif
+  for ( ; k<nwords ; k++)
+  {
+    const iWord cur = iLoadWord(src + 8*k), next = (k + 1 < nwords) ? iLoadWord(src + 8*k + 8) : 0;
+    iWord w;
+    if      (shift_amount == 0)   w = cur;
+    else if (shift_amount >= 64)  w = next;
+    else                          w = (cur >> shift_amount) | (next << (64 - shift_amount));
+    iStoreWord(dst + 8*k, w);
+  }
+}
+
+};
+// ================< end local functions
+
+namespace blepo
+{
+
+bool CanDoMmx() { iInit();  return i_can_do_mmx; }
+bool CanDoSse() { iInit();  return i_can_do_sse; }
+bool CanDoSse2() { iInit();  return i_can_do_sse2; }
+bool CanDoSse3() { iInit();  return i_can_do_sse3; }
+bool CanDoAvx2() { iInit();  return i_can_do_avx2; }
+bool CanDoAvx512() { iInit();  return i_can_do_avx512; }
+
+void TurnOffAllMmxSse()
+{
+  iInit();
+  i_can_do_mmx = i_can_do_sse = i_can_do_sse2 = i_can_do_sse3 = false;
+  i_can_do_avx2 = i_can_do_avx512 = false;
+}
+
+// ---------------- logical
+void mmx_and(const unsigned char *src1, const unsigned char *src2, unsigned char *dst, int num_quadwords      ) { iBinary<iAndOp>(src1, src2, dst, num_quadwords       * nbytes_per_quadword); }
+void xmm_and(const unsigned char *src1, const unsigned char *src2, unsigned char *dst, int num_doublequadwords) { iBinary<iAndOp>(src1, src2, dst, num_doublequadwords * nbytes_per_doublequadword); }
+void mmx_or (const unsigned char *src1, const unsigned char *src2, unsigned char *dst, int num_quadwords      ) { iBinary<iOrOp> (src1, src2, dst, num_quadwords       * nbytes_per_quadword); }
+void xmm_or (const unsigned char *src1, const unsigned char *src2, unsigned char *dst, int num_doublequadwords) { iBinary<iOrOp> (src1, src2, dst, num_doublequadwords * nbytes_per_doublequadword); }
+void mmx_xor(const unsigned char *src1, const unsigned char *src2, unsigned char *dst, int num_quadwords      ) { iBinary<iXorOp>(src1, src2, dst, num_quadwords       * nbytes_per_quadword); }
+void xmm_xor(const unsigned char *src1, const unsigned char *src2, unsigned char *dst, int num_doublequadwords) { iBinary<iXorOp>(src1, src2, dst, num_doublequadwords * nbytes_per_doublequadword); }
+void mmx_not(const unsigned char *src , unsigned char *dst, int num_quadwords      ) { iConst<iXorOp>(src, 255, dst, num_quadwords       * nbytes_per_quadword); }
+void xmm_not(const unsigned char *src , unsigned char *dst, int num_doublequadwords) { iConst<iXorOp>(src, 255, dst, num_doublequadwords * nbytes_per_doublequadword); }
+void mmx_const_and(const unsigned char *src, const unsigned char val, unsigned char *dst, int num_quadwords      ) { iConst<iAndOp>(src, val, dst, num_quadwords       * nbytes_per_quadword); }
+void xmm_const_and(const unsigned char *src, const unsigned char val, unsigned char *dst, int num_doublequadwords) { iConst<iAndOp>(src, val, dst, num_doublequadwords * nbytes_per_doublequadword); }
+void mmx_const_or (const unsigned char *src, const unsigned char val, unsigned char *dst, int num_quadwords      ) { iConst<iOrOp> (src, val, dst, num_quadwords       * nbytes_per_quadword); }
+void xmm_const_or (const unsigned char *src, const unsigned char val, unsigned char *dst, int num_doublequadwords) { iConst<iOrOp> (src, val, dst, num_doublequadwords * nbytes_per_doublequadword); }
+void mmx_const_xor(const unsigned char *src, const unsigned char val, unsigned char *dst, int num_quadwords      ) { iConst<iXorOp>(src, val, dst, num_quadwords       * nbytes_per_quadword); }
+void xmm_const_xor(const unsigned char *src, const unsigned char val, unsigned char *dst, int num_doublequadwords) { iConst<iXorOp>(src, val, dst, num_doublequadwords * nbytes_per_doublequadword); }
+
+// ---------------- shift an entire array of bits
+void mmx_shiftleft (const unsigned char *src, unsigned char *dst, int shift_amount, int num_quadwords)       { iShiftLeft (src, dst, shift_amount, num_quadwords); }
+void xmm_shiftleft (const unsigned char *src, unsigned char *dst, int shift_amount, int num_doublequadwords) { iShiftLeft (src, dst, shift_amount, num_doublequadwords * 2); }
+void mmx_shiftright(const unsigned char *src, unsigned char *dst, int shift_amount, int num_quadwords)       { iShiftRight(src, dst, shift_amount, num_quadwords); }
+void xmm_shiftright(const unsigned char *src, unsigned char *dst, int shift_amount, int num_doublequadwords) { iShiftRight(src, dst, shift_amount, num_doublequadwords * 2); }
+
+// ---------------- arithmetic
+void mmx_absdiff   (const unsigned char *src1, const unsigned char *src2, unsigned char *dst, int num_quadwords      ) { iBinary<iAbsDiffOp> (src1, src2, dst, num_quadwords       * nbytes_per_quadword); }
+void xmm_absdiff   (const unsigned char *src1, const unsigned char *src2, unsigned char *dst, int num_doublequadwords) { iBinary<iAbsDiffOp> (src1, src2, dst, num_doublequadwords * nbytes_per_doublequadword); }
+void mmx_sum       (const unsigned char *src1, const unsigned char *src2, unsigned char *dst, int num_quadwords      ) { iBinary<iSumOp>     (src1, src2, dst, num_quadwords       * nbytes_per_quadword); }
+void xmm_sum       (const unsigned char *src1, const unsigned char *src2, unsigned char *dst, int num_doublequadwords) { iBinary<iSumOp>     (src1, src2, dst, num_doublequadwords * nbytes_per_doublequadword); }
+void mmx_subtract  (const unsigned char *src1, const unsigned char *src2, unsigned char *dst, int num_quadwords      ) { iBinary<iSubtractOp>(src1, src2, dst, num_quadwords       * nbytes_per_quadword); }
+void xmm_subtract  (const unsigned char *src1, const unsigned char *src2, unsigned char *dst, int num_doublequadwords) { iBinary<iSubtractOp>(src1, src2, dst, num_doublequadwords * nbytes_per_doublequadword); }
+void mmx_const_diff(const unsigned char *src , const unsigned char val  , unsigned char *dst, int num_quadwords      ) { iConst<iAbsDiffOp>  (src, val, dst, num_quadwords       * nbytes_per_quadword); }
+void xmm_const_diff(const unsigned char *src , const unsigned char val  , unsigned char *dst, int num_doublequadwords) { iConst<iAbsDiffOp>  (src, val, dst, num_doublequadwords * nbytes_per_doublequadword); }
+void mmx_const_sum (const unsigned char *src , const unsigned char val  , unsigned char *dst, int num_quadwords      ) { iConst<iSumOp>      (src, val, dst, num_quadwords       * nbytes_per_quadword); }
+void xmm_const_sum (const unsigned char *src , const unsigned char val  , unsigned char *dst, int num_doublequadwords) { iConst<iSumOp>      (src, val, dst, num_doublequadwords * nbytes_per_doublequadword); }
+
+// ---------------- image processing
+void mmx_convolve_prewitt_horiz_abs(const unsigned char* src, unsigned char* dst, int width, int height) { iFilterHoriz<iPrewittOp>(src, dst, width, height); }
+void mmx_convolve_prewitt_vert_abs (const unsigned char* src, unsigned char* dst, int width, int height) { iFilterVert <iPrewittOp>(src, dst, width, height); }
+void mmx_gauss_1x3(const unsigned char *src, unsigned char *dst, int width, int height) { iFilterHoriz<iGaussOp>(src, dst, width, height); }
+void mmx_gauss_3x1(const unsigned char *src, unsigned char *dst, int width, int height) { iFilterVert <iGaussOp>(src, dst, width, height); }
+void mmx_erode    (const unsigned char* src, const unsigned char* kernel, unsigned char* dst, int width, int height) { iMorph(src, kernel, dst, width, height, true);  }
+void mmx_dilate   (const unsigned char* src, const unsigned char* kernel, unsigned char* dst, int width, int height) { iMorph(src, kernel, dst, width, height, false); }
+
+};  // end namespace blepo
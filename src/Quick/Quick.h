@@ -22,21 +22,29 @@
 namespace blepo
 {
 
-// These functions return whether the processor is capable of performing MMX/SSE/SSE2/SSE3 operations.
-// The capability is automatically checked once upon startup.
+// These functions return whether the processor is capable of performing MMX/SSE/SSE2/SSE3/AVX2/AVX-512 operations.
+// The capability is automatically checked (using cpuid) once upon startup.
 bool CanDoMmx();   // mmx
 bool CanDoSse();
 bool CanDoSse2();  // xmm
 bool CanDoSse3();
+bool CanDoAvx2();
+bool CanDoAvx512();  // AVX-512 F and BW
 
 // This function allows the user to change the return value of the 'CanDo' functions above.
-// After calling this function, all of the 'CanDo' functions will return false.
+// After calling this function, all of the 'CanDo' functions will return false,
+// and the functions below use plain C++ instead of SIMD instructions.
 void TurnOffAllMmxSse();
 
 const int nbytes_per_word = 2;              //  2
 const int nbytes_per_quadword = 8;          //  8  (size of MMX registers)
 const int nbytes_per_doublequadword = 16;   // 16  (size of XMM registers)
 
+// The functions below keep the names of the original MMX/SSE2 assembly routines, but they
+// are written with intrinsics.  Each one uses the widest instruction set the processor
+// supports (AVX-512, AVX2, or SSE2), finishes with narrower ones, and falls back to plain C++.
+// The 'mmx_' functions process 8*num_quadwords bytes, the 'xmm_' functions 16*num_doublequadwords.
+// It is okay if src==dst, and no alignment is assumed.
 extern "C" {
 
 // logical
@@ -56,6 +64,8 @@ void mmx_const_xor(const unsigned char *src, const unsigned char val, unsigned c
 void xmm_const_xor(const unsigned char *src, const unsigned char val, unsigned char *dst, int num_doublequadwords);
 
 // shift an entire array of bits.  Bit i of the array is in bit i%8 of byte i/8.
+// Shifting left moves bit i to bit i+shift_amount; the bits shifted in are zero.
+// shift_amount must be >= 0 and <= 64.
 void mmx_shiftleft (const unsigned char *src, unsigned char *dst, int shift_amount, int num_quadwords);
 void xmm_shiftleft (const unsigned char *src, unsigned char *dst, int shift_amount, int num_doublequadwords);
 void mmx_shiftright(const unsigned char *src, unsigned char *dst, int shift_amount, int num_quadwords);
@@ -73,7 +83,16 @@ void xmm_const_diff(const unsigned char *src , const unsigned char val  , unsign
 void mmx_const_sum (const unsigned char *src , const unsigned char val  , unsigned char *dst, int num_quadwords      );
 void xmm_const_sum (const unsigned char *src , const unsigned char val  , unsigned char *dst, int num_doublequadwords);
 
-// image processing
+// image processing (src and dst must not overlap)
+//   prewitt_horiz_abs:  |src(x+1,y) - src(x-1,y)|, for 0 < x < width-1
+//   prewitt_vert_abs:   |src(x,y+1) - src(x,y-1)|, for 0 < y < height-1
+//   gauss_1x3:          [1 2 1]/4 along each row, for 0 < x < width-1 (rounded down)
+//   gauss_3x1:          [1 2 1]/4 along each column, for 0 < y < height-1 (rounded down)
+//   The remaining pixels of dst are not changed.
+//   erode, dilate:      3x3 structuring element 'kernel' stored in rows of four bytes (the fourth
+//                       is ignored).  The output is 255 if the neighbor 'p' under every (erode) or
+//                       any (dilate) nonzero element 'k' has (p & k) == k (erode) or (p & k) != 0
+//                       (dilate), and 0 otherwise.  The one-pixel-wide border is set to zero.
 void mmx_convolve_prewitt_horiz_abs(const unsigned char* src, unsigned char* dst, int width, int height);
 void mmx_convolve_prewitt_vert_abs (const unsigned char* src, unsigned char* dst, int width, int height);
 void mmx_gauss_1x3(const unsigned char *src, unsigned char *dst, int width, int height);
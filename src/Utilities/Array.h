@@ -79,6 +79,9 @@ public:
   Array(int n) : m_autoshrink(false), m_n(0), m_data() { Reset(n); }
   Array(int n, const T& value) : m_autoshrink(false), m_n(0), m_data() { Reset(n);  SetValues(value); }
   Array(const Array& other) : m_autoshrink(false), m_n(0), m_data() { *this = other; }
+#ifdef BLEPO_HAS_RVALUE_REFERENCES
+  Array(Array&& other) : m_autoshrink(false), m_n(0), m_data() { *this = static_cast<Array&&>(other); }
+#endif
   virtual ~Array() {}
 
   /// Clears all data
@@ -87,6 +90,8 @@ public:
   /// Resizes the array; if the size is increased, then all newly allocated elements
   /// are uninitialized.  All values in [ 0,min(n1,n) ) are unchanged,
   /// where n1 is the length before calling this function -- same behavior as realloc().
+  /// Memory is not reallocated if the array fits in the memory it already has
+  /// (unless autoshrinking is on; see AutoShrink()).
   void Reset(int n) { if (n!=m_n) { iAllocate(n);  m_n = n; } }
 
   /// Assignment operator
@@ -98,6 +103,17 @@ public:
     return *this;
   }
 
+#ifdef BLEPO_HAS_RVALUE_REFERENCES
+  /// Move assignment operator:  takes the memory of 'other' instead of copying it
+  Array& operator=(Array&& other)
+  {
+    m_autoshrink = other.m_autoshrink;
+    int n = m_n;  m_n = other.m_n;  other.m_n = n;
+    m_data.Swap(other.m_data);
+    return *this;
+  }
+#endif
+
   /// Pushes a value onto the end of the array
   void Push(const T& value)
   {
@@ -227,7 +243,8 @@ private:
   {
     if (m_data.GetN() != n)
     {
-      m_data.Reset(n);
+      m_data.Reset(n);  // keeps the old block if 'n' elements fit in it
+      if (m_autoshrink && m_data.GetCapacity() > 4*n)  m_data.ShrinkToFit();
     }
   }
   /// Reallocates memory, if necessary, to accommodate an array of length 'n'.
@@ -22,59 +22,307 @@
 //#include <assert.h>
 #include "Exception.h"
 #include <stdlib.h>  // realloc()
+#include <string.h>  // memcpy()
+#ifdef _MSC_VER
+#include <malloc.h>  // _aligned_realloc()
+#if _MSC_VER >= 1400
+#include <intrin.h>  // _InterlockedIncrement()
+#endif
+#endif
+
+// Whether the compiler supports rvalue references (move constructors and move assignment)
+#if (defined(_MSC_VER) && _MSC_VER >= 1600) || __cplusplus >= 201103L
+#define BLEPO_HAS_RVALUE_REFERENCES
+#endif
+
+// Storage class for variables with one instance per thread (POD types only)
+#ifdef _MSC_VER
+#define BLEPO_THREAD_LOCAL __declspec(thread)
+#else
+#define BLEPO_THREAD_LOCAL __thread
+#endif
 
 /**
 @class Reallocator
 Reallocates an array of basic types or structs, 
 without calling the constructor on those types.
 
+The first element is always aligned on an ALIGNMENT-byte boundary, so that
+SIMD code can use aligned loads and stores on the beginning of the array.
+As with realloc(), the first min(old,new) elements are preserved by Reset().
+Reset() never shrinks the allocated block, so that an array which is resized
+to the same few sizes over and over (e.g., once per video frame) is allocated 
+only the first time; call ShrinkToFit() to give the unused memory back.
+
+Copy-on-write is off by default.  When it is turned on with SetCopyOnWrite(),
+copying the array shares its memory, with a reference count, instead of copying 
+the elements.  The elements are copied only when one of the arrays sharing them
+asks for non-const access (Begin(), End(), operator[]) or is resized.
+
 @author Stan Birchfield (STB)
 */
 
 namespace blepo
 {
 
+/// Aligned versions of realloc() and free().  The caller must pass in the
+/// old size because, unlike realloc(), the block may always move.
+//@{
+inline void* AlignedRealloc(void* p, size_t old_nbytes, size_t nbytes, size_t alignment)
+{
+#ifdef _MSC_VER
+  old_nbytes;  // unused
+  return _aligned_realloc(p, nbytes, alignment);
+#else
+  if (nbytes == 0)
+  {
+    if (p)  free(static_cast<void**>(p)[-1]);
+    return 0;
+  }
+  // over-allocate, and store the original pointer just before the aligned block
+  void* raw = malloc(nbytes + alignment + sizeof(void*));
+  if (raw == 0)  return 0;
+  size_t addr = (reinterpret_cast<size_t>(raw) + sizeof(void*) + alignment - 1) & ~(alignment - 1);
+  void* q = reinterpret_cast<void*>(addr);
+  static_cast<void**>(q)[-1] = raw;
+  if (p)
+  {
+    memcpy(q, p, old_nbytes < nbytes ? old_nbytes : nbytes);
+    free(static_cast<void**>(p)[-1]);
+  }
+  return q;
+#endif
+}
+
+inline void AlignedFree(void* p)
+{
+#ifdef _MSC_VER
+  _aligned_free(p);
+#else
+  if (p)  free(static_cast<void**>(p)[-1]);
+#endif
+}
+//@}
+
+/// Thread-safe increment and decrement, returning the new value
+//@{
+inline long AtomicIncrement(volatile long* p)
+{
+#if defined(_MSC_VER) && _MSC_VER >= 1400
+  return _InterlockedIncrement(p);
+#elif defined(__GNUC__)
+  return __sync_add_and_fetch(p, 1);
+#else
+  return ++(*p);
+#endif
+}
+
+inline long AtomicDecrement(volatile long* p)
+{
+#if defined(_MSC_VER) && _MSC_VER >= 1400
+  return _InterlockedDecrement(p);
+#elif defined(__GNUC__)
+  return __sync_sub_and_fetch(p, 1);
+#else
+  return --(*p);
+#endif
+}
+//@}
+
+/// Number of blocks (and their total size) that Reallocator has allocated on 
+/// the heap from the calling thread since the count was last cleared.  
+/// FrameArena::BeginFrame() clears it, so that it counts the allocations per frame.
+struct HeapAllocationCount
+{
+  int nallocations;
+  double nbytes;
+};
+
+inline HeapAllocationCount& GetHeapAllocationCount()
+{
+  static BLEPO_THREAD_LOCAL HeapAllocationCount count;  // zero-initialized
+  return count;
+}
+
+inline void ClearHeapAllocationCount()
+{
+  GetHeapAllocationCount().nallocations = 0;
+  GetHeapAllocationCount().nbytes = 0;
+}
+
 template <class T>
 class Reallocator
 {
 public:
   typedef T Type;
-  Reallocator() : m_nalloc(0), m_first(0), m_last(0) {}
-  Reallocator(int n) : m_nalloc(0), m_first(0), m_last(0) { Reset(n); }
-  Reallocator(const Reallocator& other) : m_nalloc(0), m_first(0), m_last(0) { *this = other; }
-  virtual ~Reallocator() { free(m_first); }
+  enum { ALIGNMENT = 64 };  ///< alignment of the first element, in bytes (one cache line, enough for AVX-512)
+  Reallocator() : m_nalloc(0), m_capacity(0), m_first(0), m_last(0), m_owner(true), m_cow(false), m_refcount(0) {}
+  Reallocator(int n) : m_nalloc(0), m_capacity(0), m_first(0), m_last(0), m_owner(true), m_cow(false), m_refcount(0) { Reset(n); }
+  Reallocator(const Reallocator& other) : m_nalloc(0), m_capacity(0), m_first(0), m_last(0), m_owner(true), m_cow(false), m_refcount(0) { *this = other; }
+#ifdef BLEPO_HAS_RVALUE_REFERENCES
+  Reallocator(Reallocator&& other) : m_nalloc(0), m_capacity(0), m_first(0), m_last(0), m_owner(true), m_cow(false), m_refcount(0) { Swap(other); }
+  Reallocator& operator=(Reallocator&& other) { Swap(other);  return *this; }
+#endif
+  virtual ~Reallocator() { iRelease(); }
   void Reset() { Reset(0); }
   void Reset(int n)
   {
-    if (m_nalloc == 0 && n == 0)  return;  // because realloc(0, 0) does not return 0; could be confusing to have non-NULL pointer when array is empty
-    m_first = static_cast<T*>( realloc(m_first, n*sizeof(T)) );
+    if (n <= m_capacity && !IsShared())
+    {  // reuse the block we already have
+      m_last = m_first + n;
+      m_nalloc = n;
+      return;
+    }
+    iReallocate(n, n);
+  }
+
+  /// Frees the memory beyond the current number of elements
+  void ShrinkToFit()
+  {
+    if (m_capacity == m_nalloc || !m_owner || IsShared())  return;
+    iReallocate(m_nalloc, m_nalloc);
+  }
+
+  /// Uses the 'n' elements at 'first' instead of heap memory.  The memory is not
+  /// freed by this object, so the caller must keep it alive for as long as it is
+  /// used (see FrameArena).  A later Reset() beyond 'n' elements moves the array 
+  /// back to the heap.
+  void Attach(T* first, int n)
+  {
+    iRelease();
+    m_first = first;
     m_last = m_first + n;
-    m_nalloc = n;
-    // If we tried to allocate memory, make sure we did
-    if (m_nalloc>0 && m_first==0)  BLEPO_ERROR("Out of memory");  
+    m_nalloc = m_capacity = n;
+    m_owner = false;
+  }
+
+  /// Exchanges the contents of two arrays without copying any elements
+  void Swap(Reallocator& other)
+  {
+    int n = m_nalloc;  m_nalloc = other.m_nalloc;  other.m_nalloc = n;
+    int c = m_capacity;  m_capacity = other.m_capacity;  other.m_capacity = c;
+    T* p = m_first;  m_first = other.m_first;  other.m_first = p;
+    p = m_last;  m_last = other.m_last;  other.m_last = p;
+    bool o = m_owner;  m_owner = other.m_owner;  other.m_owner = o;
+    o = m_cow;  m_cow = other.m_cow;  other.m_cow = o;
+    long* r = m_refcount;  m_refcount = other.m_refcount;  other.m_refcount = r;
   }
 
+  /// Copies the elements of 'other', or shares them if 'other' is copy-on-write
+  /// (in which case this array becomes copy-on-write, too).
   Reallocator& operator=(const Reallocator& other)
   {
+    if (&other == this)  return *this;
+    if (other.m_cow && other.m_owner && other.m_first)
+    {  // share the block
+      if (other.m_refcount == 0)  other.m_refcount = new long(1);
+      AtomicIncrement(other.m_refcount);
+      iRelease();
+      m_first = other.m_first;
+      m_last = other.m_last;
+      m_nalloc = other.m_nalloc;
+      m_capacity = other.m_capacity;
+      m_owner = true;
+      m_cow = true;
+      m_refcount = other.m_refcount;
+      return *this;
+    }
+    Unshare(false);
     Reset(other.m_nalloc);
     memcpy(m_first, other.m_first, m_nalloc*sizeof(T));
     return *this;
   }
 
+  /// @name Copy-on-write
+  //@{
+  void SetCopyOnWrite(bool cow) { m_cow = cow; }
+  bool IsCopyOnWrite() const { return m_cow; }
+  /// Whether the memory is currently shared with another array
+  bool IsShared() const { return m_refcount != 0 && *m_refcount > 1; }
+  /// Gives this array its own copy of the elements, if they are shared.  If
+  /// 'keep_elements' is false, the array is left empty instead, which is cheaper
+  /// when the elements are about to be overwritten anyway.
+  void Unshare(bool keep_elements = true)
+  {
+    if (!IsShared())  return;
+    if (keep_elements)  
+    {
+      iReallocate(m_nalloc, m_nalloc);
+    }
+    else
+    {
+      iRelease();
+      m_first = m_last = 0;
+      m_nalloc = m_capacity = 0;
+      m_owner = true;
+    }
+  }
+  //@}
+
   int GetN() const { return m_nalloc; }
+  int GetCapacity() const { return m_capacity; }  ///< number of elements that fit without reallocating
 
-  T& operator[](int indx) { assert(indx>=0 && indx<GetN());  return m_first[indx]; }
+  T& operator[](int indx) { assert(indx>=0 && indx<GetN());  Unshare();  return m_first[indx]; }
   const T& operator[](int indx) const { assert(indx>=0 && indx<GetN());  return m_first[indx]; }
 
-  Type* Begin() { return m_first; }
-  Type* End() { return m_last; }
+  Type* Begin() { Unshare();  return m_first; }
+  Type* End() { Unshare();  return m_last; }
   const Type* Begin() const { return m_first; }
   const Type* End() const { return m_last; }
 
 private:
+  // moves the first 'nkeep' elements to a new heap block of 'ncapacity' elements
+  void iReallocate(int nkeep, int ncapacity)
+  {
+    if (m_owner && !IsShared())
+    {
+      m_first = static_cast<T*>( AlignedRealloc(m_first, m_nalloc*sizeof(T), ncapacity*sizeof(T), ALIGNMENT) );
+    }
+    else
+    {  // the old block belongs to someone else, or is shared, so copy out of it but do not free it
+      T* first = static_cast<T*>( AlignedRealloc(0, 0, ncapacity*sizeof(T), ALIGNMENT) );
+      if (first)  memcpy(first, m_first, (m_nalloc < nkeep ? m_nalloc : nkeep)*sizeof(T));
+      iRelease();
+      m_first = first;
+      m_owner = true;
+    }
+    m_last = m_first + nkeep;
+    m_nalloc = nkeep;
+    m_capacity = ncapacity;
+    if (ncapacity > 0)
+    {
+      GetHeapAllocationCount().nallocations++;
+      GetHeapAllocationCount().nbytes += ncapacity*sizeof(T);
+    }
+    // If we tried to allocate memory, make sure we did
+    if (m_capacity>0 && m_first==0)  BLEPO_ERROR("Out of memory");  
+  }
+
+  // gives up this array's claim on its memory, freeing the memory if no one else uses it
+  void iRelease()
+  {
+    if (m_refcount)
+    {
+      if (AtomicDecrement(m_refcount) == 0)
+      {
+        AlignedFree(m_first);
+        delete m_refcount;
+      }
+      m_refcount = 0;
+    }
+    else if (m_owner)
+    {
+      AlignedFree(m_first);
+    }
+  }
+
   int m_nalloc;      //< number of elements
+  int m_capacity;    //< number of elements allocated (>= m_nalloc)
   T* m_first;  //< points to first element
   T* m_last;   //< points just past last element
+  bool m_owner;  //< whether the memory was allocated (and will be freed) by this object
+  bool m_cow;    //< whether copies share the memory (copy-on-write)
+  mutable long* m_refcount;  //< number of arrays sharing the memory, or NULL if it has never been shared
 };
 
 